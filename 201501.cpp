@@ -8,52 +8,1316 @@
 #define FMT_HEADER_ONLY
 #include "fmt/format.h"
 
+#include <bit>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(AOC_X86)
+#include <immintrin.h>
+#endif
 
 using namespace fmt;
 using namespace aoc;
 using namespace std;
 
-int floorOffset(char instruction)
+int floorOffset(char instruction)
+{
+
+	switch(instruction)
+	{
+		case '(': return 1;
+		case ')': return -1;
+	}
+
+	panic(format("invalid instruction: '{}'", instruction));
+
+	return 0;
+}
+
+int findFloor(std::string_view instructions)
+{
+	int64_t floor = 0;
+
+	for(char instruction : instructions)
+		floor += floorOffset(instruction);
+
+	return checkedAnswer(floor);
+}
+
+// Each findFloor*() function adds the floor changes of whole 64-byte blocks
+// of instructions to floor and returns the position of the first
+// unprocessed byte. A block is validated in the same pass as it is counted:
+// should any of its bytes be neither '(' nor ')', the function stops there
+// and leaves reporting the error to the per-character code.
+#if defined(AOC_X86)
+AOC_TARGET("sse2")
+static uint64_t instructionMaskSse2(const char* block,
+                                    char instruction)
+{
+	const __m128i instructionBytes = _mm_set1_epi8(instruction);
+
+	uint64_t mask = 0;
+
+	for(size_t i=0; i<4; ++i)
+	{
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * sizeof(__m128i)));
+
+		mask |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, instructionBytes)))) << (i * sizeof(__m128i));
+	}
+
+	return mask;
+}
+
+AOC_TARGET("sse2")
+static size_t findFloorSse2(std::string_view instructions,
+                            int64_t& floor)
+{
+	const size_t size = instructions.size() - (instructions.size() % 64);
+
+	for(size_t pos=0; pos<size; pos+=64)
+	{
+		const uint64_t upMask = instructionMaskSse2(instructions.data() + pos, '(');
+		const uint64_t downMask = instructionMaskSse2(instructions.data() + pos, ')');
+
+		if((upMask | downMask) != ~uint64_t(0))
+			return pos;
+
+		floor += popcount(upMask) - popcount(downMask);
+	}
+
+	return size;
+}
+
+AOC_TARGET("avx2")
+static uint64_t instructionMaskAvx2(const char* block,
+                                    char instruction)
+{
+	const __m256i instructionBytes = _mm256_set1_epi8(instruction);
+	const __m256i bytes0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+	const __m256i bytes1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + sizeof(__m256i)));
+
+	return static_cast<uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes0, instructionBytes)))) |
+	       (static_cast<uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes1, instructionBytes)))) << 32);
+}
+
+AOC_TARGET("avx2,popcnt")
+static size_t findFloorAvx2(std::string_view instructions,
+                            int64_t& floor)
+{
+	const size_t size = instructions.size() - (instructions.size() % 64);
+
+	for(size_t pos=0; pos<size; pos+=64)
+	{
+		const uint64_t upMask = instructionMaskAvx2(instructions.data() + pos, '(');
+		const uint64_t downMask = instructionMaskAvx2(instructions.data() + pos, ')');
+
+		if((upMask | downMask) != ~uint64_t(0))
+			return pos;
+
+		floor += popcount(upMask) - popcount(downMask);
+	}
+
+	return size;
+}
+
+// Each lowestFloorChange*() function returns the lowest floor, relative to
+// the starting one, reached while following a 64-byte block of valid
+// instructions, from prefix sums of the floor changes of its parts.
+AOC_TARGET("sse2")
+static int lowestFloorChangeSse2(const char* block)
+{
+	int floor = 0;
+	int lowestFloor = 0;
+
+	for(size_t i=0; i<4; ++i)
+	{
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * sizeof(__m128i)));
+		const __m128i upBytes = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('('));
+
+		// +1 for '(' (where upBytes is -1) and -1 for ')'.
+		__m128i floors = _mm_sub_epi8(_mm_set1_epi8(-1), _mm_add_epi8(upBytes, upBytes));
+
+		floors = _mm_add_epi8(floors, _mm_slli_si128(floors, 1));
+		floors = _mm_add_epi8(floors, _mm_slli_si128(floors, 2));
+		floors = _mm_add_epi8(floors, _mm_slli_si128(floors, 4));
+		floors = _mm_add_epi8(floors, _mm_slli_si128(floors, 8));
+
+		// SSE2 only has an unsigned byte minimum, hence the bias.
+		__m128i lowestFloors = _mm_xor_si128(floors, _mm_set1_epi8(-128));
+
+		lowestFloors = _mm_min_epu8(lowestFloors, _mm_srli_si128(lowestFloors, 8));
+		lowestFloors = _mm_min_epu8(lowestFloors, _mm_srli_si128(lowestFloors, 4));
+		lowestFloors = _mm_min_epu8(lowestFloors, _mm_srli_si128(lowestFloors, 2));
+		lowestFloors = _mm_min_epu8(lowestFloors, _mm_srli_si128(lowestFloors, 1));
+
+		lowestFloor = min(lowestFloor, floor + static_cast<int8_t>((_mm_cvtsi128_si32(lowestFloors) & 0xFF) ^ 0x80));
+		floor += static_cast<int8_t>(_mm_extract_epi16(floors, 7) >> 8);
+	}
+
+	return lowestFloor;
+}
+
+// Each skipBlocksAboveTheBasement*() function follows whole 64-byte blocks
+// of instructions from pos on, as long as they cannot take floor down to
+// -1, and returns the position of the first block which may (or holds an
+// invalid instruction), or of the first unprocessed byte.
+AOC_TARGET("sse2")
+static size_t skipBlocksAboveTheBasementSse2(std::string_view instructions,
+                                             size_t pos,
+                                             int64_t& floor)
+{
+	for(; instructions.size() - pos >= 64; pos+=64)
+	{
+		const uint64_t upMask = instructionMaskSse2(instructions.data() + pos, '(');
+		const uint64_t downMask = instructionMaskSse2(instructions.data() + pos, ')');
+
+		if((upMask | downMask) != ~uint64_t(0))
+			break;
+
+		// No block goes down more than 64 floors.
+		if((floor < 64) && (floor + lowestFloorChangeSse2(instructions.data() + pos) < 0))
+			break;
+
+		floor += popcount(upMask) - popcount(downMask);
+	}
+
+	return pos;
+}
+
+AOC_TARGET("avx2")
+static int lowestFloorChangeAvx2(const char* block)
+{
+	int floor = 0;
+	int lowestFloor = 0;
+
+	for(size_t i=0; i<2; ++i)
+	{
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * sizeof(__m256i)));
+		const __m256i upBytes = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('('));
+
+		__m256i floors = _mm256_sub_epi8(_mm256_set1_epi8(-1), _mm256_add_epi8(upBytes, upBytes));
+
+		// Byte shifts stay within 128-bit lanes, so the last prefix sum of the
+		// low lane is added to the high lane afterwards.
+		floors = _mm256_add_epi8(floors, _mm256_slli_si256(floors, 1));
+		floors = _mm256_add_epi8(floors, _mm256_slli_si256(floors, 2));
+		floors = _mm256_add_epi8(floors, _mm256_slli_si256(floors, 4));
+		floors = _mm256_add_epi8(floors, _mm256_slli_si256(floors, 8));
+
+		const __m256i laneFloors = _mm256_shuffle_epi8(floors, _mm256_set1_epi8(15));
+
+		floors = _mm256_add_epi8(floors, _mm256_permute2x128_si256(laneFloors, laneFloors, 0x08));
+
+		__m256i lowestFloors = _mm256_min_epi8(floors, _mm256_permute2x128_si256(floors, floors, 0x01));
+
+		lowestFloors = _mm256_min_epi8(lowestFloors, _mm256_srli_si256(lowestFloors, 8));
+		lowestFloors = _mm256_min_epi8(lowestFloors, _mm256_srli_si256(lowestFloors, 4));
+		lowestFloors = _mm256_min_epi8(lowestFloors, _mm256_srli_si256(lowestFloors, 2));
+		lowestFloors = _mm256_min_epi8(lowestFloors, _mm256_srli_si256(lowestFloors, 1));
+
+		lowestFloor = min(lowestFloor, floor + static_cast<int8_t>(_mm256_cvtsi256_si32(lowestFloors) & 0xFF));
+		floor += static_cast<int8_t>(_mm256_extract_epi8(floors, 31));
+	}
+
+	return lowestFloor;
+}
+
+AOC_TARGET("avx2,popcnt")
+static size_t skipBlocksAboveTheBasementAvx2(std::string_view instructions,
+                                             size_t pos,
+                                             int64_t& floor)
+{
+	for(; instructions.size() - pos >= 64; pos+=64)
+	{
+		const uint64_t upMask = instructionMaskAvx2(instructions.data() + pos, '(');
+		const uint64_t downMask = instructionMaskAvx2(instructions.data() + pos, ')');
+
+		if((upMask | downMask) != ~uint64_t(0))
+			break;
+
+		// No block goes down more than 64 floors.
+		if((floor < 64) && (floor + lowestFloorChangeAvx2(instructions.data() + pos) < 0))
+			break;
+
+		floor += popcount(upMask) - popcount(downMask);
+	}
+
+	return pos;
+}
+#endif
+
+// What following instructions does to the floor, up to their first invalid
+// byte: the floor change and the lowest floor change along the way. Both
+// are 64-bit, as summaries of whole subtrees of EditableInstructions may
+// cover more instructions than fit an int.
+class FloorSummary
+{
+public:
+	int64_t floorChange_ = 0;
+	int64_t lowestFloorChange_ = 0;
+	bool valid_ = true;
+};
+
+// Each summarizeBlocks*() function adds whole 64-byte blocks of valid
+// instructions to summary and returns the position of the first
+// unprocessed byte. The lowest floor of a block is only computed when the
+// block could go below the lowest floor so far.
+#if defined(AOC_X86)
+AOC_TARGET("sse2")
+static size_t summarizeBlocksSse2(std::string_view instructions,
+                                  FloorSummary& summary)
+{
+	size_t pos = 0;
+
+	for(; instructions.size() - pos >= 64; pos+=64)
+	{
+		const uint64_t upMask = instructionMaskSse2(instructions.data() + pos, '(');
+		const uint64_t downMask = instructionMaskSse2(instructions.data() + pos, ')');
+
+		if((upMask | downMask) != ~uint64_t(0))
+			break;
+
+		if(summary.floorChange_ - 64 < summary.lowestFloorChange_)
+			summary.lowestFloorChange_ = min(summary.lowestFloorChange_,
+			                                 summary.floorChange_ + lowestFloorChangeSse2(instructions.data() + pos));
+
+		summary.floorChange_ += popcount(upMask) - popcount(downMask);
+	}
+
+	return pos;
+}
+
+AOC_TARGET("avx2,popcnt")
+static size_t summarizeBlocksAvx2(std::string_view instructions,
+                                  FloorSummary& summary)
+{
+	size_t pos = 0;
+
+	for(; instructions.size() - pos >= 64; pos+=64)
+	{
+		const uint64_t upMask = instructionMaskAvx2(instructions.data() + pos, '(');
+		const uint64_t downMask = instructionMaskAvx2(instructions.data() + pos, ')');
+
+		if((upMask | downMask) != ~uint64_t(0))
+			break;
+
+		if(summary.floorChange_ - 64 < summary.lowestFloorChange_)
+			summary.lowestFloorChange_ = min(summary.lowestFloorChange_,
+			                                 summary.floorChange_ + lowestFloorChangeAvx2(instructions.data() + pos));
+
+		summary.floorChange_ += popcount(upMask) - popcount(downMask);
+	}
+
+	return pos;
+}
+#endif
+
+FloorSummary summarizeInstructions(std::string_view instructions,
+                                   InstructionSet instructionSet)
+{
+	FloorSummary summary;
+	size_t pos = 0;
+
+	switch(instructionSet)
+	{
+		case InstructionSet::Scalar:
+			break;
+
+#if defined(AOC_X86)
+		case InstructionSet::Sse2:
+			pos = summarizeBlocksSse2(instructions, summary);
+			break;
+
+		case InstructionSet::Avx2:
+			pos = summarizeBlocksAvx2(instructions, summary);
+			break;
+#else
+		default:
+			panic(format("unsupported instruction set: {}", instructionSetName(instructionSet)));
+#endif
+	}
+
+	for(; pos<instructions.size(); ++pos)
+	{
+		switch(instructions[pos])
+		{
+			case '(':
+				++summary.floorChange_;
+				break;
+
+			case ')':
+				--summary.floorChange_;
+				summary.lowestFloorChange_ = min(summary.lowestFloorChange_, summary.floorChange_);
+				break;
+
+			default:
+				summary.valid_ = false;
+				return summary;
+		}
+	}
+
+	return summary;
+}
+
+// Vectorised findFloor(), which reports invalid instructions just the same,
+// but returns the floor unchecked.
+static int64_t findFloorChange(std::string_view instructions,
+                               InstructionSet instructionSet)
+{
+	int64_t floor = 0;
+	size_t pos = 0;
+
+	switch(instructionSet)
+	{
+		case InstructionSet::Scalar:
+			break;
+
+#if defined(AOC_X86)
+		case InstructionSet::Sse2:
+			pos = findFloorSse2(instructions, floor);
+			break;
+
+		case InstructionSet::Avx2:
+			pos = findFloorAvx2(instructions, floor);
+			break;
+#else
+		default:
+			panic(format("unsupported instruction set: {}", instructionSetName(instructionSet)));
+#endif
+	}
+
+	return floor + findFloor(instructions.substr(pos));
+}
+
+int findFloor(std::string_view instructions,
+              InstructionSet instructionSet)
+{
+	return checkedAnswer(findFloorChange(instructions, instructionSet));
+}
+
+int findEnterTheBasementInstructionPosition(std::string_view instructions)
+{
+	int64_t floor = 0;
+
+	for(size_t i=0; i<instructions.size(); ++i)
+	{
+		floor += floorOffset(instructions[i]);
+
+		if(floor == -1)
+			return checkedAnswer(i + 1);
+	}
+
+	panic(format("no 'enter the basement' instruction found"));
+
+	return -1;
+}
+
+// Follows instructions from floor on until the basement is entered and
+// returns the number of instructions followed up to that point, or
+// string_view::npos with floor updated if it is not entered. Whole blocks
+// which cannot reach the basement are skipped with SIMD; only the block
+// where it may be entered, and the bytes after the last whole block, are
+// followed one instruction at a time.
+size_t followInstructionsToTheBasement(std::string_view instructions,
+                                       int64_t& floor,
+                                       InstructionSet instructionSet)
+{
+	for(size_t pos=0; pos<instructions.size();)
+	{
+		switch(instructionSet)
+		{
+			case InstructionSet::Scalar:
+				break;
+
+#if defined(AOC_X86)
+			case InstructionSet::Sse2:
+				pos = skipBlocksAboveTheBasementSse2(instructions, pos, floor);
+				break;
+
+			case InstructionSet::Avx2:
+				pos = skipBlocksAboveTheBasementAvx2(instructions, pos, floor);
+				break;
+#else
+			default:
+				panic(format("unsupported instruction set: {}", instructionSetName(instructionSet)));
+#endif
+		}
+
+		const size_t blockEnd = (instructionSet == InstructionSet::Scalar) ? instructions.size()
+		                                                                   : min(pos + 64, instructions.size());
+
+		// A local copy, which the compiler may keep in a register.
+		int64_t blockFloor = floor;
+
+		for(; pos<blockEnd; ++pos)
+		{
+			blockFloor += floorOffset(instructions[pos]);
+
+			if(blockFloor == -1)
+			{
+				floor = blockFloor;
+
+				return pos + 1;
+			}
+		}
+
+		floor = blockFloor;
+	}
+
+	return std::string_view::npos;
+}
+
+// Vectorised findEnterTheBasementInstructionPosition().
+int findEnterTheBasementInstructionPosition(std::string_view instructions,
+                                            InstructionSet instructionSet)
+{
+	int64_t floor = 0;
+
+	const size_t position = followInstructionsToTheBasement(instructions, floor, instructionSet);
+
+	if(position == std::string_view::npos)
+		panic(format("no 'enter the basement' instruction found"));
+
+	return checkedAnswer(position);
+}
+
+// Parallel findFloorChange(): the floor changes of numTasks consecutive
+// parts of the instructions are added up. The first invalid instruction is
+// still the one reported, as parallelFor() rethrows the error of the first
+// part.
+static int64_t findFloorChangeInParallel(std::string_view instructions,
+                                         size_t numTasks)
+{
+	static const InstructionSet instructionSet = detectInstructionSet();
+
+	if(numTasks <= 1)
+		return findFloorChange(instructions, instructionSet);
+
+	vector<int64_t> floors(numTasks);
+
+	parallelFor(numTasks, [&](size_t taskIndex)
+	{
+		const size_t start = instructions.size() * taskIndex / numTasks;
+		const size_t end = instructions.size() * (taskIndex + 1) / numTasks;
+
+		floors[taskIndex] = findFloorChange(instructions.substr(start, end - start), instructionSet);
+	});
+
+	int64_t floor = 0;
+
+	for(int64_t partFloor : floors)
+		floor += partFloor;
+
+	return floor;
+}
+
+int findFloorInParallel(std::string_view instructions,
+                        size_t numTasks)
+{
+	return checkedAnswer(findFloorChangeInParallel(instructions, numTasks));
+}
+
+// Parallel followInstructionsToTheBasement(), a two-pass scan over rounds
+// of numTasks consecutive parts: the parts are summarized in parallel, an
+// exclusive scan of their floor changes gives the floor each part starts
+// on, and the first part whose lowest floor reaches the basement (or which
+// holds an invalid instruction) is followed sequentially. Working in rounds
+// bounds the work wasted past an early basement.
+size_t followInstructionsToTheBasementInParallel(std::string_view instructions,
+                                                 int64_t& floor,
+                                                 size_t numTasks)
+{
+	static const InstructionSet instructionSet = detectInstructionSet();
+
+	if(numTasks <= 1)
+		return followInstructionsToTheBasement(instructions, floor, instructionSet);
+
+	constexpr size_t partSize = 16 << 20;
+
+	vector<FloorSummary> summaries(numTasks);
+
+	for(size_t roundStart=0; roundStart<instructions.size(); roundStart+=numTasks * partSize)
+	{
+		const std::string_view round = instructions.substr(roundStart, numTasks * partSize);
+
+		const auto part = [&](size_t taskIndex)
+		{
+			const size_t start = round.size() * taskIndex / numTasks;
+			const size_t end = round.size() * (taskIndex + 1) / numTasks;
+
+			return round.substr(start, end - start);
+		};
+
+		parallelFor(numTasks, [&](size_t taskIndex)
+		{
+			summaries[taskIndex] = summarizeInstructions(part(taskIndex), instructionSet);
+		});
+
+		for(size_t taskIndex=0; taskIndex<numTasks; ++taskIndex)
+		{
+			const FloorSummary& summary = summaries[taskIndex];
+
+			if(summary.valid_ && (floor + summary.lowestFloorChange_ > -1))
+			{
+				floor += summary.floorChange_;
+
+				continue;
+			}
+
+			const size_t position = followInstructionsToTheBasement(part(taskIndex), floor, instructionSet);
+
+			AOC_ASSERT(position != std::string_view::npos);
+
+			return roundStart + (part(taskIndex).data() - round.data()) + position;
+		}
+	}
+
+	return std::string_view::npos;
+}
+
+int findEnterTheBasementInstructionPositionInParallel(std::string_view instructions,
+                                                      size_t numTasks)
+{
+	int64_t floor = 0;
+
+	const size_t position = followInstructionsToTheBasementInParallel(instructions, floor, numTasks);
+
+	if(position == std::string_view::npos)
+		panic(format("no 'enter the basement' instruction found"));
+
+	return checkedAnswer(position);
+}
+
+// Streaming counterparts of findFloor() and
+// findEnterTheBasementInstructionPosition(), which accept the instructions
+// in consecutive pieces. Pieces of instructionsChunkSize bytes are split
+// into one parallel task per worker thread, for up to 16 of them, while the
+// memory of the streamed chunks stays the same however many cores there are.
+constexpr size_t instructionsChunkSize = 16 << 20;
+
+class FloorAccumulator
+{
+public:
+	void followInstructions(std::string_view instructions);
+	int floor() const { return checkedAnswer(floor_); }
+
+private:
+	int64_t floor_ = 0;
+};
+
+void FloorAccumulator::followInstructions(std::string_view instructions)
+{
+	floor_ += findFloorChangeInParallel(instructions, numParallelTasks(instructions.size()));
+}
+
+class EnterTheBasementAccumulator
+{
+public:
+	void followInstructions(std::string_view instructions);
+	int position() const;
+
+private:
+	int64_t floor_ = 0;
+	size_t numInstructions_ = 0;
+	size_t position_ = std::string_view::npos;
+};
+
+void EnterTheBasementAccumulator::followInstructions(std::string_view instructions)
+{
+	if(position_ != std::string_view::npos)
+		return;
+
+	const size_t position = followInstructionsToTheBasementInParallel(instructions, floor_, numParallelTasks(instructions.size()));
+
+	if(position != std::string_view::npos)
+		position_ = numInstructions_ + position;
+	else
+		numInstructions_ += instructions.size();
+}
+
+int EnterTheBasementAccumulator::position() const
+{
+	if(position_ == std::string_view::npos)
+		panic(format("no 'enter the basement' instruction found"));
+
+	return checkedAnswer(position_);
+}
+
+// Answers floor queries over instructions which are indexed once up front.
+// Positions count followed instructions, so the floor at position 0 is 0 and
+// the one at position size() is what findFloor() returns. The instructions
+// are split into 64-byte blocks; the floor at the start of every block is
+// stored, and a segment tree over the blocks holds the lowest and highest
+// floor reached within each of them. The instructions must outlive the
+// index.
+class FloorIndex
+{
+public:
+	class FloorRange
+	{
+	public:
+		int64_t lowest_ = INT64_MAX;
+		int64_t highest_ = INT64_MIN;
+	};
+
+	explicit FloorIndex(std::string_view instructions);
+
+	size_t size() const { return instructions_.size(); }
+	int64_t floorAt(size_t position) const;
+	size_t firstPositionReachingFloor(int64_t floor) const;
+	FloorRange floorRange(size_t first,
+	                      size_t last) const;
+
+private:
+	static constexpr size_t blockSize = 64;
+
+	static FloorRange merge(const FloorRange& range,
+	                        const FloorRange& otherRange);
+	void checkPosition(size_t position) const;
+	FloorRange scanFloorRange(size_t first,
+	                          size_t last) const;
+
+	std::string_view instructions_;
+	vector<int64_t> blockFloors_;
+	size_t numLeaves_ = 1;
+	vector<FloorRange> tree_;
+};
+
+FloorIndex::FloorIndex(std::string_view instructions) :
+	instructions_{instructions}
+{
+	const size_t numBlocks = (instructions.size() + blockSize - 1) / blockSize;
+
+	numLeaves_ = bit_ceil(max<size_t>(numBlocks, 1));
+	blockFloors_.assign(numBlocks + 1, 0);
+	tree_.resize(2 * numLeaves_);
+
+	// Each block is first summarised relative to its own start, so the
+	// blocks can be handled in parallel; the block floors then follow from
+	// a prefix sum of their floor changes.
+	const size_t numTasks = min(numParallelTasks(instructions.size()), max<size_t>(numBlocks, 1));
+
+	parallelFor(numTasks, [&](size_t taskIndex)
+	{
+		for(size_t block=numBlocks * taskIndex / numTasks; block<numBlocks * (taskIndex + 1) / numTasks; ++block)
+		{
+			FloorRange& range = tree_[numLeaves_ + block];
+			int64_t floor = 0;
+
+			for(char instruction : instructions.substr(block * blockSize, blockSize))
+			{
+				floor += floorOffset(instruction);
+				range.lowest_ = min(range.lowest_, floor);
+				range.highest_ = max(range.highest_, floor);
+			}
+
+			blockFloors_[block + 1] = floor;
+		}
+	});
+
+	for(size_t block=0; block<numBlocks; ++block)
+	{
+		FloorRange& range = tree_[numLeaves_ + block];
+
+		range.lowest_ += blockFloors_[block];
+		range.highest_ += blockFloors_[block];
+		blockFloors_[block + 1] += blockFloors_[block];
+	}
+
+	for(size_t node=numLeaves_ - 1; node>=1; --node)
+		tree_[node] = merge(tree_[2 * node], tree_[2 * node + 1]);
+}
+
+FloorIndex::FloorRange FloorIndex::merge(const FloorRange& range,
+                                         const FloorRange& otherRange)
+{
+	return { min(range.lowest_, otherRange.lowest_), max(range.highest_, otherRange.highest_) };
+}
+
+void FloorIndex::checkPosition(size_t position) const
+{
+	if(position > instructions_.size())
+		panic(format("position {} is past the end of {} instructions", position, instructions_.size()));
+}
+
+int64_t FloorIndex::floorAt(size_t position) const
+{
+	checkPosition(position);
+
+	const size_t block = position / blockSize;
+	int64_t floor = blockFloors_[block];
+
+	for(char instruction : instructions_.substr(block * blockSize, position - block * blockSize))
+		floor += (instruction == '(') ? 1 : -1;
+
+	return floor;
+}
+
+// Returns std::string_view::npos if the floor is never reached. Since every
+// instruction moves one floor, the first block whose lowest (or highest)
+// floor goes past the target is the one that reaches it, and the tree is
+// descended towards the leftmost such block.
+size_t FloorIndex::firstPositionReachingFloor(int64_t floor) const
+{
+	if(floor == 0)
+		return 0;
+
+	const auto reaches = [floor](const FloorRange& range)
+	{
+		return (floor < 0) ? (range.lowest_ <= floor) : (range.highest_ >= floor);
+	};
+
+	if(!reaches(tree_[1]))
+		return std::string_view::npos;
+
+	size_t node = 1;
+
+	while(node < numLeaves_)
+		node = reaches(tree_[2 * node]) ? 2 * node : 2 * node + 1;
+
+	const size_t block = node - numLeaves_;
+	int64_t currentFloor = blockFloors_[block];
+
+	for(size_t position=block * blockSize; ; ++position)
+	{
+		currentFloor += (instructions_[position] == '(') ? 1 : -1;
+
+		if(currentFloor == floor)
+			return position + 1;
+	}
+}
+
+FloorIndex::FloorRange FloorIndex::scanFloorRange(size_t first,
+                                                  size_t last) const
+{
+	int64_t floor = floorAt(first);
+	FloorRange range{floor, floor};
+
+	for(char instruction : instructions_.substr(first, last - first))
+	{
+		floor += (instruction == '(') ? 1 : -1;
+		range = merge(range, { floor, floor });
+	}
+
+	return range;
+}
+
+// Returns the lowest and highest floor at the positions first to last,
+// inclusive. The blocks lying wholly within the range come from the tree,
+// the partial ones at either end are scanned.
+FloorIndex::FloorRange FloorIndex::floorRange(size_t first,
+                                              size_t last) const
+{
+	checkPosition(last);
+
+	if(first > last)
+		panic(format("invalid position range [{}, {}]", first, last));
+
+	// Block b covers the floors at positions b * 64 + 1 to (b + 1) * 64.
+	const size_t firstBlock = (first + blockSize - 1) / blockSize;
+	const size_t endBlock = last / blockSize;
+
+	if(firstBlock >= endBlock)
+		return scanFloorRange(first, last);
+
+	FloorRange range = merge(scanFloorRange(first, firstBlock * blockSize),
+	                         scanFloorRange(endBlock * blockSize, last));
+
+	for(size_t left=numLeaves_ + firstBlock, right=numLeaves_ + endBlock; left<right; left/=2, right/=2)
+	{
+		if(left & 1)
+			range = merge(range, tree_[left++]);
+
+		if(right & 1)
+			range = merge(range, tree_[--right]);
+	}
+
+	return range;
+}
+
+// Instructions which can be edited in place while keeping the final floor
+// and the 'enter the basement' position up to date. They are held in chunks
+// of 128 to 256 bytes (only a lone chunk may be shorter) in a treap ordered
+// by position, whose nodes carry the FloorSummary of their subtree. Edits
+// which keep a single chunk within those bounds change it in place; others
+// split off the chunks they touch, together with a neighbour on either
+// side, and cut them into chunks anew. Either way an edit costs O(log n)
+// plus the size of the edit, the number of chunks stays proportional to the
+// number of instructions, and both queries are answered from the summaries
+// without rescanning the instructions.
+class EditableInstructions
+{
+public:
+	explicit EditableInstructions(std::string_view instructions = {});
+
+	size_t size() const { return subtreeSize(root_.get()); }
+	int floor() const { return checkedAnswer(subtreeSummary(root_.get()).floorChange_); }
+	size_t enterTheBasementPosition() const;
+	string toString() const;
+	size_t numChunks() const;
+
+	void insert(size_t position,
+	            std::string_view instructions);
+	void erase(size_t position,
+	           size_t count);
+	void replace(size_t position,
+	             std::string_view instructions);
+
+private:
+	static constexpr size_t maxChunkSize = 256;
+	static constexpr size_t minChunkSize = maxChunkSize / 2;
+
+	class Node
+	{
+	public:
+		string chunk_;
+		FloorSummary chunkSummary_;
+		uint64_t priority_ = 0;
+		size_t size_ = 0;
+		FloorSummary summary_;
+		unique_ptr<Node> left_;
+		unique_ptr<Node> right_;
+	};
+
+	static void checkInstructions(std::string_view instructions);
+	static FloorSummary append(const FloorSummary& summary,
+	                           const FloorSummary& nextSummary);
+	static size_t subtreeSize(const Node* node) { return node ? node->size_ : 0; }
+	static FloorSummary subtreeSummary(const Node* node) { return node ? node->summary_ : FloorSummary{}; }
+	static void summarizeChunk(Node& node);
+	static void update(Node& node);
+	static unique_ptr<Node> merge(unique_ptr<Node> node,
+	                              unique_ptr<Node> nextNode);
+	static bool insertIntoChunk(Node& node,
+	                            size_t position,
+	                            std::string_view instructions);
+	static bool eraseFromChunk(Node& node,
+	                           size_t position,
+	                           size_t count);
+	static void replaceInChunks(Node& node,
+	                            size_t position,
+	                            std::string_view instructions);
+	static void appendInstructions(const Node* node,
+	                               string& instructions);
+
+	unique_ptr<Node> makeNodes(std::string_view instructions);
+	pair<unique_ptr<Node>, unique_ptr<Node>> split(unique_ptr<Node> node,
+	                                               size_t position);
+	pair<size_t, size_t> chunkRange(size_t position) const;
+	void rechunk(size_t position,
+	             size_t count,
+	             std::string_view instructions);
+
+	unique_ptr<Node> root_;
+	mt19937_64 random_;
+};
+
+EditableInstructions::EditableInstructions(std::string_view instructions)
+{
+	checkInstructions(instructions);
+
+	root_ = makeNodes(instructions);
+}
+
+// Panics about the first byte which is neither '(' nor ')', so that the
+// treap only ever holds valid instructions.
+void EditableInstructions::checkInstructions(std::string_view instructions)
+{
+	const size_t position = instructions.find_first_not_of("()");
+
+	if(position != std::string_view::npos)
+		floorOffset(instructions[position]);
+}
+
+FloorSummary EditableInstructions::append(const FloorSummary& summary,
+                                          const FloorSummary& nextSummary)
+{
+	return { summary.floorChange_ + nextSummary.floorChange_,
+	         min(summary.lowestFloorChange_, summary.floorChange_ + nextSummary.lowestFloorChange_) };
+}
+
+void EditableInstructions::summarizeChunk(Node& node)
+{
+	static const InstructionSet instructionSet = detectInstructionSet();
+
+	node.chunkSummary_ = summarizeInstructions(node.chunk_, instructionSet);
+}
+
+void EditableInstructions::update(Node& node)
+{
+	node.size_ = subtreeSize(node.left_.get()) + node.chunk_.size() + subtreeSize(node.right_.get());
+	node.summary_ = append(append(subtreeSummary(node.left_.get()), node.chunkSummary_), subtreeSummary(node.right_.get()));
+}
+
+unique_ptr<EditableInstructions::Node> EditableInstructions::merge(unique_ptr<Node> node,
+                                                                   unique_ptr<Node> nextNode)
+{
+	if(!node)
+		return nextNode;
+
+	if(!nextNode)
+		return node;
+
+	if(node->priority_ > nextNode->priority_)
+	{
+		node->right_ = merge(std::move(node->right_), std::move(nextNode));
+		update(*node);
+
+		return node;
+	}
+
+	nextNode->left_ = merge(std::move(node), std::move(nextNode->left_));
+	update(*nextNode);
+
+	return nextNode;
+}
+
+// Cuts the instructions into as few chunks as possible, all of about the
+// same size, so that none of them is shorter than minChunkSize unless it is
+// the only one.
+unique_ptr<EditableInstructions::Node> EditableInstructions::makeNodes(std::string_view instructions)
+{
+	const size_t numChunks = (instructions.size() + maxChunkSize - 1) / maxChunkSize;
+
+	unique_ptr<Node> nodes;
+
+	for(size_t chunk=0; chunk<numChunks; ++chunk)
+	{
+		const size_t start = instructions.size() * chunk / numChunks;
+		const size_t end = instructions.size() * (chunk + 1) / numChunks;
+
+		auto node = make_unique<Node>();
+
+		node->chunk_ = instructions.substr(start, end - start);
+		node->priority_ = random_();
+		summarizeChunk(*node);
+		update(*node);
+
+		nodes = merge(std::move(nodes), std::move(node));
+	}
+
+	return nodes;
+}
+
+// Splits off the first position instructions; a chunk straddling the split
+// is cut in two.
+pair<unique_ptr<EditableInstructions::Node>, unique_ptr<EditableInstructions::Node>> EditableInstructions::split(unique_ptr<Node> node,
+                                                                                                                size_t position)
+{
+	if(!node)
+		return {};
+
+	const size_t leftSize = subtreeSize(node->left_.get());
+
+	if(position <= leftSize)
+	{
+		auto [left, right] = split(std::move(node->left_), position);
+
+		node->left_ = std::move(right);
+		update(*node);
+
+		return { std::move(left), std::move(node) };
+	}
+
+	if(position >= leftSize + node->chunk_.size())
+	{
+		auto [left, right] = split(std::move(node->right_), position - leftSize - node->chunk_.size());
+
+		node->right_ = std::move(left);
+		update(*node);
+
+		return { std::move(node), std::move(right) };
+	}
+
+	unique_ptr<Node> right = merge(makeNodes(std::string_view(node->chunk_).substr(position - leftSize)), std::move(node->right_));
+
+	node->chunk_.resize(position - leftSize);
+	summarizeChunk(*node);
+	update(*node);
+
+	return { std::move(node), std::move(right) };
+}
+
+// Returns false, leaving the node alone, if the chunk at position has no
+// room for the instructions.
+bool EditableInstructions::insertIntoChunk(Node& node,
+                                           size_t position,
+                                           std::string_view instructions)
+{
+	const size_t leftSize = subtreeSize(node.left_.get());
+	bool inserted = false;
+
+	if(position < leftSize)
+		inserted = insertIntoChunk(*node.left_, position, instructions);
+	else if(position > leftSize + node.chunk_.size())
+		inserted = insertIntoChunk(*node.right_, position - leftSize - node.chunk_.size(), instructions);
+	else if(node.chunk_.size() + instructions.size() <= maxChunkSize)
+	{
+		node.chunk_.insert(position - leftSize, instructions);
+		summarizeChunk(node);
+		inserted = true;
+	}
+
+	if(inserted)
+		update(node);
+
+	return inserted;
+}
+
+// Returns false, leaving the node alone, unless the instructions to erase
+// lie within a single chunk which keeps at least minChunkSize of them.
+bool EditableInstructions::eraseFromChunk(Node& node,
+                                          size_t position,
+                                          size_t count)
+{
+	const size_t leftSize = subtreeSize(node.left_.get());
+	const size_t rightStart = leftSize + node.chunk_.size();
+	bool erased = false;
+
+	if(position < leftSize)
+		erased = (position + count <= leftSize) && eraseFromChunk(*node.left_, position, count);
+	else if(position >= rightStart)
+		erased = eraseFromChunk(*node.right_, position - rightStart, count);
+	else if((position + count <= rightStart) && (node.chunk_.size() - count >= minChunkSize))
+	{
+		node.chunk_.erase(position - leftSize, count);
+		summarizeChunk(node);
+		erased = true;
+	}
+
+	if(erased)
+		update(node);
+
+	return erased;
+}
+
+void EditableInstructions::replaceInChunks(Node& node,
+                                           size_t position,
+                                           std::string_view instructions)
+{
+	const size_t leftSize = subtreeSize(node.left_.get());
+	const size_t rightStart = leftSize + node.chunk_.size();
+	const size_t end = position + instructions.size();
+
+	if(position < leftSize)
+		replaceInChunks(*node.left_, position, instructions.substr(0, leftSize - position));
+
+	if((position < rightStart) && (end > leftSize))
+	{
+		const size_t start = max(position, leftSize);
+
+		node.chunk_.replace(start - leftSize, min(end, rightStart) - start, instructions.substr(start - position, min(end, rightStart) - start));
+		summarizeChunk(node);
+	}
+
+	if(end > rightStart)
+	{
+		const size_t start = max(position, rightStart);
+
+		replaceInChunks(*node.right_, start - rightStart, instructions.substr(start - position));
+	}
+
+	update(node);
+}
+
+void EditableInstructions::appendInstructions(const Node* node,
+                                              string& instructions)
+{
+	if(!node)
+		return;
+
+	appendInstructions(node->left_.get(), instructions);
+	instructions += node->chunk_;
+	appendInstructions(node->right_.get(), instructions);
+}
+
+// Returns the start and the end of the chunk holding the instruction at
+// position, which must be before size().
+pair<size_t, size_t> EditableInstructions::chunkRange(size_t position) const
+{
+	size_t start = 0;
+
+	for(const Node* node=root_.get();;)
+	{
+		const size_t leftSize = subtreeSize(node->left_.get());
+
+		if(position < leftSize)
+		{
+			node = node->left_.get();
+			continue;
+		}
+
+		start += leftSize;
+		position -= leftSize;
+
+		if(position < node->chunk_.size())
+			return { start, start + node->chunk_.size() };
+
+		start += node->chunk_.size();
+		position -= node->chunk_.size();
+		node = node->right_.get();
+	}
+}
+
+// Replaces count instructions at position with the given ones. The chunks
+// touched are split off along with a neighbour on either side, whose sizes
+// are within bounds, and cut anew, so that no chunk ends up empty or
+// shorter than minChunkSize.
+void EditableInstructions::rechunk(size_t position,
+                                   size_t count,
+                                   std::string_view instructions)
 {
+	size_t start = position;
+	size_t end = position + count;
 
-	switch(instruction)
+	for(size_t i=0; (i<2) && (start>0); ++i)
+		start = chunkRange(start - 1).first;
+
+	for(size_t i=0; (i<2) && (end<size()); ++i)
+		end = chunkRange(end).second;
+
+	// Both bounds are at chunk boundaries, so only the chunks of the window
+	// may be cut.
+	auto [left, rest] = split(std::move(root_), start);
+	auto [window, right] = split(std::move(rest), end - start);
+	auto [head, windowRest] = split(std::move(window), position - start);
+	auto [erased, tail] = split(std::move(windowRest), count);
+
+	string windowInstructions;
+
+	windowInstructions.reserve(subtreeSize(head.get()) + instructions.size() + subtreeSize(tail.get()));
+	appendInstructions(head.get(), windowInstructions);
+	windowInstructions += instructions;
+	appendInstructions(tail.get(), windowInstructions);
+
+	root_ = merge(merge(std::move(left), makeNodes(windowInstructions)), std::move(right));
+}
+
+// Returns std::string_view::npos if the basement is never entered.
+size_t EditableInstructions::enterTheBasementPosition() const
+{
+	static const InstructionSet instructionSet = detectInstructionSet();
+
+	int64_t floor = 0;
+	size_t position = 0;
+
+	for(const Node* node=root_.get(); node && (floor + node->summary_.lowestFloorChange_ <= -1);)
 	{
-		case '(': return 1;
-		case ')': return -1;
+		const FloorSummary leftSummary = subtreeSummary(node->left_.get());
+
+		if(floor + leftSummary.lowestFloorChange_ <= -1)
+		{
+			node = node->left_.get();
+			continue;
+		}
+
+		floor += leftSummary.floorChange_;
+		position += subtreeSize(node->left_.get());
+
+		if(floor + node->chunkSummary_.lowestFloorChange_ <= -1)
+			return position + followInstructionsToTheBasement(node->chunk_, floor, instructionSet);
+
+		floor += node->chunkSummary_.floorChange_;
+		position += node->chunk_.size();
+		node = node->right_.get();
 	}
 
-	panic(format("invalid instruction: '{}'", instruction));
+	return std::string_view::npos;
+}
 
-	return 0;
+string EditableInstructions::toString() const
+{
+	string instructions;
+
+	instructions.reserve(size());
+	appendInstructions(root_.get(), instructions);
+
+	return instructions;
 }
 
-int findFloor(const string& instructions)
+size_t EditableInstructions::numChunks() const
 {
-	int floor = 0;
+	const auto countNodes = [](const auto& countNodes, const Node* node) -> size_t
+	{
+		return node ? countNodes(countNodes, node->left_.get()) + 1 + countNodes(countNodes, node->right_.get()) : 0;
+	};
 
-	for(char instruction : instructions)
-		floor += floorOffset(instruction);
+	return countNodes(countNodes, root_.get());
+}
 
-	return floor;
+void EditableInstructions::insert(size_t position,
+                                  std::string_view instructions)
+{
+	if(position > size())
+		panic(format("position {} is past the end of {} instructions", position, size()));
+
+	checkInstructions(instructions);
+
+	if(instructions.empty() || (root_ && insertIntoChunk(*root_, position, instructions)))
+		return;
+
+	rechunk(position, 0, instructions);
 }
 
-int findEnterTheBasementInstructionPosition(const string& instructions)
+void EditableInstructions::erase(size_t position,
+                                 size_t count)
 {
-	int floor = 0;
+	if((position > size()) || (count > size() - position))
+		panic(format("range [{}, {}) is past the end of {} instructions", position, position + count, size()));
 
-	for(size_t i=0; i<instructions.size(); ++i)
+	if((count == 0) || eraseFromChunk(*root_, position, count))
+		return;
+
+	rechunk(position, count, {});
+}
+
+// Overwrites as many instructions as given, starting at position.
+void EditableInstructions::replace(size_t position,
+                                   std::string_view instructions)
+{
+	if((position > size()) || (instructions.size() > size() - position))
+		panic(format("range [{}, {}) is past the end of {} instructions", position, position + instructions.size(), size()));
+
+	checkInstructions(instructions);
+
+	if(!instructions.empty())
+		replaceInChunks(*root_, position, instructions);
+}
+
+// Writes size instructions, a random walk which goes up with probability
+// "upProbability" (0.51 by default, like the real input, which ends 138
+// floors up after 7000 instructions). Should the walk never reach the
+// basement, it is followed by just enough ')' to get there.
+void generateInstructions(ostream& stream,
+                          const InputGeneration& inputGeneration)
+{
+	const double upProbability = inputGeneration.parameter("upProbability", 0.51);
+
+	InputRandom random{inputGeneration.seed_};
+	GeneratedInputWriter writer{stream};
+	int64_t floor = 0;
+	bool basementEntered = false;
+
+	for(size_t i=0; i<inputGeneration.size_; ++i)
 	{
-		floor += floorOffset(instructions[i]);
+		const bool up = random.chance(upProbability);
 
-		if(floor == -1)
-			return i + 1;
+		writer.put(up ? '(' : ')');
+		floor += up ? 1 : -1;
+		basementEntered = basementEntered || (floor == -1);
 	}
 
-	panic(format("no 'enter the basement' instruction found"));
-
-	return -1;
+	for(; !basementEntered && (floor >= 0); --floor)
+		writer.put(')');
 }
 
 #ifdef AOC_TEST_SOLUTION
@@ -85,6 +1349,34 @@ TEST_CASE("findFloor")
 	CHECK_THROWS_WITH_AS(findFloor(")())())#"), "invalid instruction: '#'", runtime_error);
 }
 
+TEST_CASE("findFloor with instruction set")
+{
+	string instructions;
+
+	for(size_t i=0; i<300; ++i)
+		instructions += (i % 3 == 0) ? ')' : '(';
+
+	for(int instructionSet=0; instructionSet<=static_cast<int>(detectInstructionSet()); ++instructionSet)
+	{
+		CAPTURE(instructionSetName(InstructionSet(instructionSet)));
+
+		for(size_t length=0; length<=instructions.size(); ++length)
+			CHECK(findFloor(std::string_view(instructions).substr(0, length), InstructionSet(instructionSet)) ==
+			      findFloor(std::string_view(instructions).substr(0, length)));
+
+		for(size_t pos : { 0, 1, 63, 64, 100, 255, 299 })
+		{
+			string invalidInstructions = instructions;
+
+			invalidInstructions[pos] = '#';
+
+			CHECK_THROWS_WITH_AS(findFloor(invalidInstructions, InstructionSet(instructionSet)), "invalid instruction: '#'", runtime_error);
+		}
+
+		CHECK_THROWS_WITH_AS(findFloor(string(64, '(') + "\n" + string(64, '('), InstructionSet(instructionSet)), "invalid instruction: '\n'", runtime_error);
+	}
+}
+
 TEST_CASE("findEnterTheBasementInstructionPosition")
 {
 	CHECK(findEnterTheBasementInstructionPosition(")") == 1);
@@ -97,32 +1389,638 @@ TEST_CASE("findEnterTheBasementInstructionPosition")
 	CHECK_THROWS_WITH_AS(findEnterTheBasementInstructionPosition("(((())))"), "no 'enter the basement' instruction found", runtime_error);
 }
 
+TEST_CASE("findEnterTheBasementInstructionPosition with instruction set")
+{
+	for(int instructionSet=0; instructionSet<=static_cast<int>(detectInstructionSet()); ++instructionSet)
+	{
+		CAPTURE(instructionSetName(InstructionSet(instructionSet)));
+
+		const auto find = [&](std::string_view instructions)
+		{
+			return findEnterTheBasementInstructionPosition(instructions, InstructionSet(instructionSet));
+		};
+
+		CHECK(find(")") == 1);
+		CHECK(find("()())") == 5);
+
+		// Entering the basement at every position of, and around, a few blocks,
+		// after a climb high enough for whole blocks to be skipped.
+		for(size_t height : { 0, 10, 63, 64, 65, 200 })
+		{
+			for(size_t numPairs : { 0, 1, 31, 32, 33, 100 })
+			{
+				string instructions = string(height, '(');
+
+				for(size_t i=0; i<numPairs; ++i)
+					instructions += "()";
+
+				instructions += string(height + 1, ')');
+
+				const size_t position = instructions.size();
+
+				instructions += "((())";
+
+				CHECK(find(instructions) == static_cast<int>(position));
+				CHECK(find(instructions + string(200, '(')) == static_cast<int>(position));
+			}
+		}
+
+		CHECK_THROWS_WITH_AS(find("_()())"), "invalid instruction: '_'", runtime_error);
+		CHECK_THROWS_WITH_AS(find(string(100, '(') + "$" + string(200, ')')), "invalid instruction: '$'", runtime_error);
+		CHECK(find(string(10, '(') + string(11, ')') + "$" + string(100, '(')) == 21);
+		CHECK_THROWS_WITH_AS(find(""), "no 'enter the basement' instruction found", runtime_error);
+		CHECK_THROWS_WITH_AS(find(string(1000, '(')), "no 'enter the basement' instruction found", runtime_error);
+		CHECK_THROWS_WITH_AS(find(string(500, '(') + string(500, ')')), "no 'enter the basement' instruction found", runtime_error);
+	}
+}
+
+TEST_CASE("summarizeInstructions")
+{
+	const auto summarize = [](std::string_view instructions)
+	{
+		FloorSummary summary;
+
+		for(char instruction : instructions)
+		{
+			if((instruction != '(') && (instruction != ')'))
+			{
+				summary.valid_ = false;
+				break;
+			}
+
+			summary.floorChange_ += floorOffset(instruction);
+			summary.lowestFloorChange_ = min(summary.lowestFloorChange_, summary.floorChange_);
+		}
+
+		return summary;
+	};
+
+	InputRandom random{1};
+	string instructions;
+
+	for(size_t i=0; i<1000; ++i)
+		instructions += random.chance((i < 500) ? 0.4 : 0.6) ? '(' : ')';
+
+	for(int instructionSet=0; instructionSet<=static_cast<int>(detectInstructionSet()); ++instructionSet)
+	{
+		CAPTURE(instructionSetName(InstructionSet(instructionSet)));
+
+		for(size_t length : { 0, 1, 63, 64, 65, 200, 1000 })
+		{
+			for(const string& text : { instructions.substr(0, length), instructions.substr(0, length) + "x" + instructions })
+			{
+				const FloorSummary expectedSummary = summarize(text);
+				const FloorSummary summary = summarizeInstructions(text, InstructionSet(instructionSet));
+
+				CHECK(summary.floorChange_ == expectedSummary.floorChange_);
+				CHECK(summary.lowestFloorChange_ == expectedSummary.lowestFloorChange_);
+				CHECK(summary.valid_ == expectedSummary.valid_);
+			}
+		}
+	}
+}
+
+TEST_CASE("findFloorInParallel")
+{
+	const string instructions = string(1000, '(') + string(1003, ')');
+
+	for(size_t numTasks=1; numTasks<=5; ++numTasks)
+	{
+		CHECK(findFloorInParallel("", numTasks) == 0);
+		CHECK(findFloorInParallel(instructions, numTasks) == -3);
+		CHECK_THROWS_WITH_AS(findFloorInParallel(instructions + "@" + instructions + "#", numTasks), "invalid instruction: '@'", runtime_error);
+	}
+}
+
+TEST_CASE("findEnterTheBasementInstructionPositionInParallel")
+{
+	for(size_t numTasks=1; numTasks<=5; ++numTasks)
+	{
+		CAPTURE(numTasks);
+
+		CHECK(findEnterTheBasementInstructionPositionInParallel(")", numTasks) == 1);
+		CHECK(findEnterTheBasementInstructionPositionInParallel(string(1000, '(') + string(1001, ')') + string(500, '('), numTasks) == 2001);
+		CHECK(findEnterTheBasementInstructionPositionInParallel(string(1000, '(') + string(1001, ')') + "#", numTasks) == 2001);
+		CHECK_THROWS_WITH_AS(findEnterTheBasementInstructionPositionInParallel(string(1000, '(') + "#" + string(1001, ')'), numTasks), "invalid instruction: '#'", runtime_error);
+		CHECK_THROWS_WITH_AS(findEnterTheBasementInstructionPositionInParallel(string(1000, '('), numTasks), "no 'enter the basement' instruction found", runtime_error);
+
+		int64_t floor = 5;
+
+		CHECK(followInstructionsToTheBasementInParallel(string(100, '(') + string(105, ')'), floor, numTasks) == std::string_view::npos);
+		CHECK(floor == 0);
+	}
+
+	// Past the first round of 16 MiB parts.
+	const string instructions = string(20 << 20, '(') + string((20 << 20) + 1, ')');
+
+	CHECK(findEnterTheBasementInstructionPositionInParallel(instructions, 2) == static_cast<int>(instructions.size()));
+}
+
+TEST_CASE("FloorAccumulator")
+{
+	FloorAccumulator floorAccumulator1;
+	CHECK(floorAccumulator1.floor() == 0);
+
+	FloorAccumulator floorAccumulator2;
+	floorAccumulator2.followInstructions("))(");
+	floorAccumulator2.followInstructions("");
+	floorAccumulator2.followInstructions("((((");
+	CHECK(floorAccumulator2.floor() == 3);
+
+	FloorAccumulator floorAccumulator3;
+	floorAccumulator3.followInstructions(")())");
+	CHECK_THROWS_WITH_AS(floorAccumulator3.followInstructions("())#"), "invalid instruction: '#'", runtime_error);
+}
+
+TEST_CASE("EnterTheBasementAccumulator")
+{
+	EnterTheBasementAccumulator enterTheBasementAccumulator1;
+	enterTheBasementAccumulator1.followInstructions(")");
+	CHECK(enterTheBasementAccumulator1.position() == 1);
+
+	EnterTheBasementAccumulator enterTheBasementAccumulator2;
+	enterTheBasementAccumulator2.followInstructions("()");
+	enterTheBasementAccumulator2.followInstructions("(");
+	enterTheBasementAccumulator2.followInstructions(")))");
+	enterTheBasementAccumulator2.followInstructions("$");
+	CHECK(enterTheBasementAccumulator2.position() == 5);
+
+	EnterTheBasementAccumulator enterTheBasementAccumulator3;
+	enterTheBasementAccumulator3.followInstructions("(((");
+	CHECK_THROWS_WITH_AS(enterTheBasementAccumulator3.followInstructions("($"), "invalid instruction: '$'", runtime_error);
+
+	EnterTheBasementAccumulator enterTheBasementAccumulator4;
+	enterTheBasementAccumulator4.followInstructions("((((");
+	enterTheBasementAccumulator4.followInstructions("))))");
+	CHECK_THROWS_WITH_AS(enterTheBasementAccumulator4.position(), "no 'enter the basement' instruction found", runtime_error);
+}
+
+TEST_CASE("instructionsChunkSize")
+{
+	const unsigned numThreads = numWorkerThreads();
+
+	// Chunks of the solution are split into one task per worker thread.
+	for(unsigned numWorkerThreads : { 1, 2, 3, 8 })
+	{
+		CAPTURE(numWorkerThreads);
+
+		setNumWorkerThreads(numWorkerThreads);
+		CHECK(numParallelTasks(instructionsChunkSize) == numWorkerThreads);
+	}
+
+	setNumWorkerThreads(3);
+
+	const string instructions = string(instructionsChunkSize - 1, '(') + string(instructionsChunkSize + 2, ')');
+
+	FloorAccumulator floorAccumulator;
+	EnterTheBasementAccumulator enterTheBasementAccumulator;
+
+	for(size_t pos=0; pos<instructions.size(); pos+=instructionsChunkSize)
+	{
+		floorAccumulator.followInstructions(std::string_view(instructions).substr(pos, instructionsChunkSize));
+		enterTheBasementAccumulator.followInstructions(std::string_view(instructions).substr(pos, instructionsChunkSize));
+	}
+
+	CHECK(floorAccumulator.floor() == -3);
+	CHECK(enterTheBasementAccumulator.position() == static_cast<int>(2 * instructionsChunkSize - 1));
+
+	setNumWorkerThreads(numThreads);
+}
+
+TEST_CASE("FloorIndex")
+{
+	const FloorIndex emptyFloorIndex{""};
+	CHECK(emptyFloorIndex.floorAt(0) == 0);
+	CHECK(emptyFloorIndex.firstPositionReachingFloor(0) == 0);
+	CHECK(emptyFloorIndex.firstPositionReachingFloor(-1) == std::string_view::npos);
+	CHECK(emptyFloorIndex.floorRange(0, 0).lowest_ == 0);
+	CHECK(emptyFloorIndex.floorRange(0, 0).highest_ == 0);
+
+	const FloorIndex floorIndex{"(()))("};
+	CHECK(floorIndex.floorAt(2) == 2);
+	CHECK(floorIndex.floorAt(6) == 0);
+	CHECK(floorIndex.firstPositionReachingFloor(2) == 2);
+	CHECK(floorIndex.firstPositionReachingFloor(-1) == 5);
+	CHECK(floorIndex.firstPositionReachingFloor(3) == std::string_view::npos);
+	CHECK(floorIndex.floorRange(1, 4).lowest_ == 0);
+	CHECK(floorIndex.floorRange(1, 4).highest_ == 2);
+	CHECK_THROWS_WITH_AS(floorIndex.floorAt(7), "position 7 is past the end of 6 instructions", runtime_error);
+	CHECK_THROWS_WITH_AS(floorIndex.floorRange(3, 2), "invalid position range [3, 2]", runtime_error);
+	CHECK_THROWS_WITH_AS(floorIndex.floorRange(0, 7), "position 7 is past the end of 6 instructions", runtime_error);
+	CHECK_THROWS_WITH_AS(FloorIndex{string(1000, '(') + "*" + string(1000, ')')}, "invalid instruction: '*'", runtime_error);
+
+	for(size_t size : { 63, 64, 65, 1000, 5000 })
+	{
+		CAPTURE(size);
+
+		ostringstream stream;
+		generateInstructions(stream, { size, size, {} });
+		const string instructions = stream.str();
+		const FloorIndex instructionsFloorIndex{instructions};
+
+		vector<int> floors{0};
+
+		for(char instruction : instructions)
+			floors.push_back(floors.back() + floorOffset(instruction));
+
+		REQUIRE(instructionsFloorIndex.size() == instructions.size());
+
+		for(size_t position=0; position<floors.size(); ++position)
+			CHECK(instructionsFloorIndex.floorAt(position) == floors[position]);
+
+		for(int floor=*min_element(floors.begin(), floors.end()) - 1; floor<=*max_element(floors.begin(), floors.end()) + 1; ++floor)
+		{
+			const auto position = find(floors.begin(), floors.end(), floor);
+
+			CHECK(instructionsFloorIndex.firstPositionReachingFloor(floor) == ((position != floors.end()) ? position - floors.begin() : std::string_view::npos));
+		}
+
+		CHECK(static_cast<int>(instructionsFloorIndex.firstPositionReachingFloor(-1)) == findEnterTheBasementInstructionPosition(instructions));
+
+		InputRandom random{size};
+
+		for(size_t i=0; i<1000; ++i)
+		{
+			size_t first = random.uniform(0, floors.size() - 1);
+			size_t last = random.uniform(0, floors.size() - 1);
+
+			if(first > last)
+				swap(first, last);
+
+			CAPTURE(first);
+			CAPTURE(last);
+
+			const FloorIndex::FloorRange range = instructionsFloorIndex.floorRange(first, last);
+
+			CHECK(range.lowest_ == *min_element(floors.begin() + first, floors.begin() + last + 1));
+			CHECK(range.highest_ == *max_element(floors.begin() + first, floors.begin() + last + 1));
+		}
+	}
+}
+
+TEST_CASE("EditableInstructions")
+{
+	EditableInstructions emptyInstructions;
+	CHECK(emptyInstructions.size() == 0);
+	CHECK(emptyInstructions.floor() == 0);
+	CHECK(emptyInstructions.enterTheBasementPosition() == std::string_view::npos);
+	emptyInstructions.erase(0, 0);
+	emptyInstructions.replace(0, "");
+	emptyInstructions.insert(0, "())");
+	CHECK(emptyInstructions.toString() == "())");
+	CHECK(emptyInstructions.enterTheBasementPosition() == 3);
+
+	EditableInstructions instructions{"(()))("};
+	CHECK(instructions.floor() == 0);
+	CHECK(instructions.enterTheBasementPosition() == 5);
+	instructions.replace(4, "(");
+	CHECK(instructions.toString() == "(())((");
+	CHECK(instructions.floor() == 2);
+	CHECK(instructions.enterTheBasementPosition() == std::string_view::npos);
+	instructions.insert(0, ")");
+	CHECK(instructions.enterTheBasementPosition() == 1);
+	instructions.erase(0, 2);
+	CHECK(instructions.toString() == "())((");
+	CHECK(instructions.enterTheBasementPosition() == 3);
+	CHECK_THROWS_WITH_AS(instructions.insert(1, "(x"), "invalid instruction: 'x'", runtime_error);
+	CHECK_THROWS_WITH_AS(instructions.replace(0, ")!"), "invalid instruction: '!'", runtime_error);
+	CHECK_THROWS_WITH_AS(EditableInstructions{"(()?"}, "invalid instruction: '?'", runtime_error);
+	CHECK_THROWS_WITH_AS(instructions.insert(6, "("), "position 6 is past the end of 5 instructions", runtime_error);
+	CHECK_THROWS_WITH_AS(instructions.erase(3, 3), "range [3, 6) is past the end of 5 instructions", runtime_error);
+	CHECK_THROWS_WITH_AS(instructions.replace(4, "()"), "range [4, 6) is past the end of 5 instructions", runtime_error);
+	CHECK(instructions.toString() == "())((");
+
+	// Random edits of all sizes, checked against a plain string.
+	ostringstream stream;
+	generateInstructions(stream, { 5000, 1, { { "upProbability", 0.52 } } });
+	string expectedInstructions = stream.str();
+	EditableInstructions editableInstructions{expectedInstructions};
+	InputRandom random{2};
+
+	const auto randomInstructions = [&random]()
+	{
+		string instructions(random.chance(0.8) ? random.uniform(0, 10) : random.uniform(0, 1000), '(');
+
+		for(char& instruction : instructions)
+			instruction = random.chance(0.5) ? '(' : ')';
+
+		return instructions;
+	};
+
+	for(size_t i=0; i<2000; ++i)
+	{
+		CAPTURE(i);
+
+		const size_t position = random.uniform(0, expectedInstructions.size());
+		const string edit = randomInstructions();
+
+		switch(random.uniform(0, 2))
+		{
+			case 0:
+				editableInstructions.insert(position, edit);
+				expectedInstructions.insert(position, edit);
+				break;
+
+			case 1:
+			{
+				const size_t count = min(edit.size(), expectedInstructions.size() - position);
+
+				editableInstructions.erase(position, count);
+				expectedInstructions.erase(position, count);
+				break;
+			}
+
+			case 2:
+			{
+				const string replacement = edit.substr(0, expectedInstructions.size() - position);
+
+				editableInstructions.replace(position, replacement);
+				expectedInstructions.replace(position, replacement.size(), replacement);
+				break;
+			}
+		}
+
+		int64_t floor = 0;
+
+		REQUIRE(editableInstructions.size() == expectedInstructions.size());
+		REQUIRE(editableInstructions.floor() == findFloor(expectedInstructions));
+		REQUIRE(editableInstructions.enterTheBasementPosition() == followInstructionsToTheBasement(expectedInstructions, floor, InstructionSet::Scalar));
+		REQUIRE(editableInstructions.numChunks() <= expectedInstructions.size() / 128 + 1);
+
+		if(i % 100 == 0)
+			REQUIRE(editableInstructions.toString() == expectedInstructions);
+	}
+
+	// Chunks emptied or shrunk by small edits are joined with their
+	// neighbours.
+	EditableInstructions shrinkingInstructions{string(64 * 1024, '(')};
+	CHECK(shrinkingInstructions.numChunks() == 256);
+
+	for(size_t size=64 * 1024; size>1000; size-=3)
+		shrinkingInstructions.erase(size / 3, 3);
+
+	CHECK(shrinkingInstructions.numChunks() <= shrinkingInstructions.size() / 128 + 1);
+
+	for(size_t i=0; i<1000; ++i)
+		shrinkingInstructions.erase(shrinkingInstructions.size() / 2, 1);
+
+	CHECK(shrinkingInstructions.toString().empty());
+	CHECK(shrinkingInstructions.numChunks() == 0);
+
+	shrinkingInstructions.insert(0, string(1000, '('));
+
+	for(size_t i=0; i<1000; ++i)
+		shrinkingInstructions.insert(i * 2, ")");
+
+	CHECK(shrinkingInstructions.size() == 2000);
+	CHECK(shrinkingInstructions.numChunks() <= 2000 / 128 + 1);
+	CHECK(shrinkingInstructions.enterTheBasementPosition() == 1);
+}
+
+TEST_CASE("generateInstructions")
+{
+	const auto generate = [](size_t size, uint64_t seed, vector<pair<string, double>> parameters = {})
+	{
+		ostringstream stream;
+		generateInstructions(stream, { size, seed, parameters });
+		return stream.str();
+	};
+
+	CHECK(generate(0, 1) == ")");
+	CHECK(generate(100000, 1) == generate(100000, 1));
+	CHECK(generate(100000, 1) != generate(100000, 2));
+	CHECK(generate(100000, 1).size() >= 100000);
+	CHECK(generate(100000, 1).substr(0, 1000) == generate(1000, 1).substr(0, 1000));
+	CHECK(generate(100, 1, { { "upProbability", 0.0 } }) == string(100, ')'));
+	CHECK(generate(100, 1, { { "upProbability", 1.0 } }) == string(100, '(') + string(101, ')'));
+
+	for(uint64_t seed=0; seed<20; ++seed)
+	{
+		const string instructions = generate(10000, seed);
+
+		CHECK(instructions.find_first_not_of("()") == string::npos);
+		CHECK(findEnterTheBasementInstructionPosition(instructions) > 0);
+		CHECK(findFloor(instructions) > -200);
+		CHECK(findFloor(instructions) < 600);
+	}
+}
+
+// Generated instructions, a quarter of which have one of them replaced with
+// an invalid byte, for checking optimised kernels against findFloor() and
+// findEnterTheBasementInstructionPosition().
+vector<string> generateDifferentialInstructions(const InputGeneration& inputGeneration)
+{
+	ostringstream stream;
+	generateInstructions(stream, inputGeneration);
+
+	string instructions = stream.str();
+	InputRandom random{inputGeneration.seed_};
+
+	if(random.chance(0.25))
+		instructions[random.uniform(0, instructions.size() - 1)] = static_cast<char>(random.uniform(0, 255));
+
+	return { instructions };
+}
+
+TEST_CASE("differential findFloor")
+{
+	vector<KernelVariant> variants = {
+		{ "FloorAccumulator", kernelOutcome([](std::string_view instructions)
+		{
+			FloorAccumulator floorAccumulator;
+
+			for(size_t pos=0; pos<instructions.size(); pos+=7)
+				floorAccumulator.followInstructions(instructions.substr(pos, 7));
+
+			return floorAccumulator.floor();
+		}) }
+	};
+
+	for(int instructionSet=0; instructionSet<=static_cast<int>(detectInstructionSet()); ++instructionSet)
+		variants.push_back({ format("findFloor ({})", instructionSetName(InstructionSet(instructionSet))),
+		                     kernelOutcome([instructionSet](std::string_view instructions)
+		                     {
+		                         return findFloor(instructions, InstructionSet(instructionSet));
+		                     }) });
+
+	for(size_t numTasks : { 2, 3, 7 })
+		variants.push_back({ format("findFloorInParallel ({} tasks)", numTasks),
+		                     kernelOutcome([numTasks](std::string_view instructions)
+		                     {
+		                         return findFloorInParallel(instructions, numTasks);
+		                     }) });
+
+	variants.push_back({ "FloorIndex", kernelOutcome([](std::string_view instructions)
+	                                   {
+	                                       const FloorIndex floorIndex{instructions};
+	                                       return floorIndex.floorAt(floorIndex.size());
+	                                   }) });
+	variants.push_back({ "EditableInstructions", kernelOutcome([](std::string_view instructions)
+	                                             {
+	                                                 return EditableInstructions{instructions}.floor();
+	                                             }) });
+
+	const optional<KernelDivergence> divergence = findKernelDivergence(generateDifferentialInstructions,
+	                                                                   kernelOutcome([](std::string_view instructions)
+	                                                                   {
+	                                                                       return findFloor(instructions);
+	                                                                   }),
+	                                                                   variants,
+	                                                                   { 0, 1, 31, 32, 33, 63, 64, 65, 1000, 100000 },
+	                                                                   20);
+
+	CHECK_MESSAGE(!divergence.has_value(), (divergence ? divergence->toString() : string()));
+}
+
+TEST_CASE("differential findEnterTheBasementInstructionPosition")
+{
+	vector<KernelVariant> variants = {
+		{ "EnterTheBasementAccumulator", kernelOutcome([](std::string_view instructions)
+		{
+			EnterTheBasementAccumulator enterTheBasementAccumulator;
+
+			for(size_t pos=0; pos<instructions.size(); pos+=7)
+				enterTheBasementAccumulator.followInstructions(instructions.substr(pos, 7));
+
+			return enterTheBasementAccumulator.position();
+		}) },
+		{ "EnterTheBasementAccumulator (whole blocks)", kernelOutcome([](std::string_view instructions)
+		{
+			EnterTheBasementAccumulator enterTheBasementAccumulator;
+
+			for(size_t pos=0; pos<instructions.size(); pos+=1000)
+				enterTheBasementAccumulator.followInstructions(instructions.substr(pos, 1000));
+
+			return enterTheBasementAccumulator.position();
+		}) }
+	};
+
+	for(int instructionSet=0; instructionSet<=static_cast<int>(detectInstructionSet()); ++instructionSet)
+		variants.push_back({ format("findEnterTheBasementInstructionPosition ({})", instructionSetName(InstructionSet(instructionSet))),
+		                     kernelOutcome([instructionSet](std::string_view instructions)
+		                     {
+		                         return findEnterTheBasementInstructionPosition(instructions, InstructionSet(instructionSet));
+		                     }) });
+
+	for(size_t numTasks : { 2, 3, 7 })
+		variants.push_back({ format("findEnterTheBasementInstructionPositionInParallel ({} tasks)", numTasks),
+		                     kernelOutcome([numTasks](std::string_view instructions)
+		                     {
+		                         return findEnterTheBasementInstructionPositionInParallel(instructions, numTasks);
+		                     }) });
+
+	const optional<KernelDivergence> divergence = findKernelDivergence(generateDifferentialInstructions,
+	                                                                   kernelOutcome([](std::string_view instructions)
+	                                                                   {
+	                                                                       return findEnterTheBasementInstructionPosition(instructions);
+	                                                                   }),
+	                                                                   variants,
+	                                                                   { 0, 1, 31, 32, 33, 63, 64, 65, 1000, 100000 },
+	                                                                   20);
+
+	CHECK_MESSAGE(!divergence.has_value(), (divergence ? divergence->toString() : string()));
+}
+
 #else
 
-class NotQuiteLisp : public PuzzleSolution
+class NotQuiteLisp : public StreamingPuzzleSolution
 {
+public:
+	NotQuiteLisp() : StreamingPuzzleSolution(instructionsChunkSize) {}
+
 private:
+	void startInput() override;
+	void processChunk(std::string_view chunk) override;
+	void generateInput(ostream& stream,
+	                   const InputGeneration& inputGeneration) const override;
 	int answer1() override;
 	int answer2() override;
+
+private:
+	size_t numLines_ = 0;
+	bool lineInProgress_ = false;
+	FloorAccumulator floorAccumulator_;
+	EnterTheBasementAccumulator enterTheBasementAccumulator_;
 };
 
+void NotQuiteLisp::startInput()
+{
+	numLines_ = 0;
+	lineInProgress_ = false;
+	floorAccumulator_ = FloorAccumulator();
+	enterTheBasementAccumulator_ = EnterTheBasementAccumulator();
+}
+
+void NotQuiteLisp::processChunk(std::string_view chunk)
+{
+	while(!chunk.empty())
+	{
+		if(!lineInProgress_)
+		{
+			++numLines_;
+			lineInProgress_ = true;
+		}
+
+		const size_t lineEndPos = chunk.find('\n');
+		const std::string_view instructions = chunk.substr(0, lineEndPos);
+
+		if(numLines_ == 1)
+		{
+			floorAccumulator_.followInstructions(instructions);
+			enterTheBasementAccumulator_.followInstructions(instructions);
+		}
+
+		if(lineEndPos == std::string_view::npos)
+			break;
+
+		lineInProgress_ = false;
+		chunk.remove_prefix(lineEndPos + 1);
+	}
+}
+
+void NotQuiteLisp::generateInput(ostream& stream,
+                                 const InputGeneration& inputGeneration) const
+{
+	generateInstructions(stream, inputGeneration);
+}
+
 int NotQuiteLisp::answer1()
 {
-	AOC_ASSERT_MSG(input().size() == 1, "invalid size of the input: only one line expected");
+	AOC_ASSERT_MSG(numLines_ == 1, "invalid size of the input: only one line expected");
 
-	return findFloor(input()[0]);
+	return floorAccumulator_.floor();
 }
 
 int NotQuiteLisp::answer2()
 {
-	AOC_ASSERT_MSG(input().size() == 1, "invalid size of the input: only one line expected");
+	AOC_ASSERT_MSG(numLines_ == 1, "invalid size of the input: only one line expected");
+
+	return enterTheBasementAccumulator_.position();
+}
+
+AOC_REGISTER_PUZZLE_SOLUTION(NotQuiteLisp, "201501");
+
+#if defined(AOC_FUZZ)
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	static FuzzTarget enterTheBasementTarget{"findEnterTheBasementInstructionPosition"};
+
+	enterTheBasementTarget.run(std::string_view(reinterpret_cast<const char*>(data), size), [](std::string_view instructions)
+	{
+		return findEnterTheBasementInstructionPosition(instructions);
+	});
 
-	return findEnterTheBasementInstructionPosition(input()[0]);
+	return 0;
 }
 
+#elif !defined(AOC_RUNNER)
+
 int main(int argc, char* argv[])
 {
-	return NotQuiteLisp().run((argc > 1) ? argv[1] : "201501.txt");
+	return NotQuiteLisp().run(argc, argv, "201501.txt");
 }
 
 #endif
+
+#endif
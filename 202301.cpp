@@ -8,7 +8,13 @@
 #define FMT_HEADER_ONLY
 #include "fmt/format.h"
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <ostream>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <tuple>
 
 using namespace fmt;
@@ -37,7 +43,7 @@ DigitNameToDigit digitNameToDigitLut[] =
 	{ "nine", '9' },
 };
 
-tuple<size_t, char> findFirstDigitByChar(const string& line)
+tuple<size_t, char> findFirstDigitByChar(std::string_view line)
 {
 	auto pos = line.find_first_of(digits);
 
@@ -45,7 +51,7 @@ tuple<size_t, char> findFirstDigitByChar(const string& line)
 	                             : make_tuple(string::npos, '\0');
 }
 
-tuple<size_t, char> findLastDigitByChar(const string& line)
+tuple<size_t, char> findLastDigitByChar(std::string_view line)
 {
 	auto pos = line.find_last_of(digits);
 
@@ -53,7 +59,7 @@ tuple<size_t, char> findLastDigitByChar(const string& line)
 	                             : make_tuple(string::npos, '\0');
 }
 
-tuple<size_t, char> findFirstDigitByName(const string& line)
+tuple<size_t, char> findFirstDigitByName(std::string_view line)
 {
 	auto firstDigitNamePos = line.size();
 	auto firstDigitNameIndex = 0U;
@@ -82,7 +88,7 @@ tuple<size_t, char> findFirstDigitByName(const string& line)
 		return make_tuple(string::npos, '\0');
 }
 
-tuple<size_t, char> findLastDigitByName(const string& line)
+tuple<size_t, char> findLastDigitByName(std::string_view line)
 {
 	auto lastDigitNamePos = 0U;
 	auto lastDigitNameIndex = 0U;
@@ -95,14 +101,13 @@ tuple<size_t, char> findLastDigitByName(const string& line)
 		if(pos == string::npos)
 			continue;
 
-		digitNameFound = true;
-
-		if(pos > lastDigitNamePos)
+		if(!digitNameFound || (pos > lastDigitNamePos))
 		{
 			lastDigitNamePos = pos;
 			lastDigitNameIndex = i;
 		}
 
+		digitNameFound = true;
 	}
 
 	if(digitNameFound)
@@ -112,7 +117,7 @@ tuple<size_t, char> findLastDigitByName(const string& line)
 		return make_tuple(string::npos, '\0');
 }
 
-char findFirstDigit(const string& line)
+char findFirstDigit(std::string_view line)
 {
 	const auto [firstDigitFoundByCharPos, firstDigitFoundByChar] =
 		findFirstDigitByChar(line);
@@ -134,7 +139,7 @@ char findFirstDigit(const string& line)
 		                                                             : firstDigitFoundByName;
 }
 
-char findLastDigit(const string& line)
+char findLastDigit(std::string_view line)
 {
 	const auto [lastDigitFoundByCharPos, lastDigitFoundByChar] =
 		findLastDigitByChar(line);
@@ -168,7 +173,7 @@ int digitsToInt(char digit1, char digit2)
 	return 10 * digitToInt(digit1) + digitToInt(digit2);
 }
 
-int extractCalibrationValue1(const string& line)
+int extractCalibrationValue1(std::string_view line)
 {
 	const auto [firstDigitPos, firstDigit] = findFirstDigitByChar(line);
 
@@ -182,11 +187,85 @@ int extractCalibrationValue1(const string& line)
 	return digitsToInt(firstDigit, lastDigit);
 }
 
-int extractCalibrationValue2(const string& line)
+int extractCalibrationValue2(std::string_view line)
 {
 	return digitsToInt(findFirstDigit(line), findLastDigit(line));
 }
 
+// Returns the digit (either character or name) starting at pos, or '\0'.
+char digitAt(std::string_view line,
+             size_t pos)
+{
+	if(isdigit(static_cast<unsigned char>(line[pos])))
+		return line[pos];
+
+	for(const auto& digitNameToDigit : digitNameToDigitLut)
+		if(line.substr(pos).starts_with(digitNameToDigit.digitName_))
+			return digitNameToDigit.digit_;
+
+	return '\0';
+}
+
+// Same as extractCalibrationValue2(), but looks for the first digit from
+// the front and for the last one from the back, stopping at the first
+// match, instead of searching the whole line for every digit name.
+int extractCalibrationValue2SinglePass(std::string_view line)
+{
+	char firstDigit = '\0';
+
+	for(size_t pos=0; (pos < line.size()) && !firstDigit; ++pos)
+		firstDigit = digitAt(line, pos);
+
+	if(!firstDigit)
+		panic(format("at least one digit (either character or name) expected in input line: '{}'", line));
+
+	char lastDigit = '\0';
+
+	for(size_t pos=line.size(); !lastDigit; --pos)
+		lastDigit = digitAt(line, pos - 1);
+
+	return digitsToInt(firstDigit, lastDigit);
+}
+
+// Writes size calibration lines of 5-50 lowercase letters and digits. Each
+// character starts a digit with probability "digitDensity" (0.15 by
+// default), which is spelled out with probability "digitNameDensity" (0.5
+// by default); a line without a digit character gets one at a random
+// position, as every line of the real input has one.
+void generateCalibrationDocument(ostream& stream,
+                                 const InputGeneration& inputGeneration)
+{
+	const double digitDensity = inputGeneration.parameter("digitDensity", 0.15);
+	const double digitNameDensity = inputGeneration.parameter("digitNameDensity", 0.5);
+
+	InputRandom random{inputGeneration.seed_};
+	GeneratedInputWriter writer{stream};
+	string line;
+
+	for(size_t i=0; i<inputGeneration.size_; ++i)
+	{
+		const size_t lineLength = random.uniform(5, 50);
+
+		line.clear();
+
+		while(line.size() < lineLength)
+		{
+			if(!random.chance(digitDensity))
+				line += static_cast<char>(random.uniform('a', 'z'));
+			else if(random.chance(digitNameDensity))
+				line += digitNameToDigitLut[random.uniform(1, 9)].digitName_;
+			else
+				line += static_cast<char>(random.uniform('1', '9'));
+		}
+
+		if(line.find_first_of(digits) == string::npos)
+			line.insert(line.begin() + random.uniform(0, line.size()), static_cast<char>(random.uniform('1', '9')));
+
+		writer.append(line);
+		writer.put('\n');
+	}
+}
+
 #ifdef AOC_TEST_SOLUTION
 
 TEST_CASE("findFirstDigitByChar")
@@ -225,6 +304,9 @@ TEST_CASE("findLastDigitByName")
 	CHECK(findLastDigitByName("4nineeightseven2") == make_tuple(10, '7'));
 	CHECK(findLastDigitByName("zoneight234") == make_tuple(3, '8'));
 	CHECK(findLastDigitByName("7pqrstsixteen") == make_tuple(6, '6'));
+	CHECK(findLastDigitByName("one") == make_tuple(0, '1'));
+	CHECK(findLastDigitByName("sevenxyz") == make_tuple(0, '7'));
+	CHECK(findLastDigitByName("xyz") == make_tuple(string::npos, '\0'));
 }
 
 TEST_CASE("findFirstDigit")
@@ -327,40 +409,184 @@ TEST_CASE("extractCalibrationValue2")
 	CHECK_THROWS_WITH_AS(extractCalibrationValue2(""), "at least one digit (either character or name) expected in input line: ''", runtime_error);
 	CHECK_THROWS_WITH_AS(extractCalibrationValue2("a"), "at least one digit (either character or name) expected in input line: 'a'", runtime_error);
 	CHECK_THROWS_WITH_AS(extractCalibrationValue2("abc"), "at least one digit (either character or name) expected in input line: 'abc'", runtime_error);
+	CHECK(extractCalibrationValue2("one") == 11);
+	CHECK(extractCalibrationValue2("sevenxyz") == 77);
+}
+
+TEST_CASE("extractCalibrationValue2SinglePass")
+{
+	CHECK(extractCalibrationValue2SinglePass("0") == 0);
+	CHECK(extractCalibrationValue2SinglePass("1a0") == 10);
+	CHECK(extractCalibrationValue2SinglePass("one") == 11);
+	CHECK(extractCalibrationValue2SinglePass("sevenxyz") == 77);
+	CHECK(extractCalibrationValue2SinglePass("two1nine") == 29);
+	CHECK(extractCalibrationValue2SinglePass("eightwothree") == 83);
+	CHECK(extractCalibrationValue2SinglePass("xtwone3four") == 24);
+	CHECK(extractCalibrationValue2SinglePass("zoneight234") == 14);
+	CHECK(extractCalibrationValue2SinglePass("7pqrstsixteen") == 76);
+	CHECK(extractCalibrationValue2SinglePass("zerone") == 1);
+	CHECK_THROWS_WITH_AS(extractCalibrationValue2SinglePass(""), "at least one digit (either character or name) expected in input line: ''", runtime_error);
+	CHECK_THROWS_WITH_AS(extractCalibrationValue2SinglePass("abc"), "at least one digit (either character or name) expected in input line: 'abc'", runtime_error);
+}
+
+TEST_CASE("generateCalibrationDocument")
+{
+	const auto generate = [](size_t size, uint64_t seed, vector<pair<string, double>> parameters = {})
+	{
+		ostringstream stream;
+		generateCalibrationDocument(stream, { size, seed, parameters });
+		return stream.str();
+	};
+
+	CHECK(generate(0, 1).empty());
+	CHECK(generate(1000, 1) == generate(1000, 1));
+	CHECK(generate(1000, 1) != generate(1000, 2));
+
+	const auto countDigits = [](const string& document)
+	{
+		size_t numDigitChars = 0;
+		size_t numDigitNames = 0;
+
+		for(size_t pos=0; pos<document.size(); ++pos)
+		{
+			numDigitChars += isdigit(document[pos]) ? 1 : 0;
+
+			for(size_t i=1; i<AOC_NUM_ELEMENTS(digitNameToDigitLut); ++i)
+				numDigitNames += document.compare(pos, strlen(digitNameToDigitLut[i].digitName_), digitNameToDigitLut[i].digitName_) == 0;
+		}
+
+		return make_tuple(numDigitChars, numDigitNames);
+	};
+
+	const string document = generate(1000, 1);
+	const auto [numDigitChars, numDigitNames] = countDigits(document);
+
+	CHECK(count(document.begin(), document.end(), '\n') == 1000);
+	CHECK(document.find_first_not_of("abcdefghijklmnopqrstuvwxyz123456789\n") == string::npos);
+	CHECK(numDigitNames > numDigitChars * 3 / 4);
+	CHECK(numDigitNames < numDigitChars * 3 / 2);
+
+	istringstream lines{document};
+	string line;
+
+	while(getline(lines, line))
+	{
+		CHECK(line.size() >= 5);
+		CHECK(line.size() <= 55);
+		CHECK(extractCalibrationValue1(line) >= 11);
+		CHECK(extractCalibrationValue2(line) >= 11);
+	}
+
+	const auto [numDigitCharsWithoutNames, numDigitNamesWithoutNames] = countDigits(generate(1000, 1, { { "digitNameDensity", 0.0 } }));
+
+	CHECK(numDigitNamesWithoutNames < numDigitCharsWithoutNames / 20);
+}
+
+// The lines of a generated calibration document, dense in spelled out
+// digits for odd seeds, with the digit characters of every eighth line
+// removed so that lines without any digit occur too.
+vector<string> generateDifferentialCalibrationLines(const InputGeneration& inputGeneration)
+{
+	ostringstream stream;
+	generateCalibrationDocument(stream, { inputGeneration.size_,
+	                                      inputGeneration.seed_,
+	                                      { { "digitNameDensity", (inputGeneration.seed_ % 2 == 1) ? 0.9 : 0.5 } } });
+
+	istringstream lines{stream.str()};
+	vector<string> result;
+
+	for(string line; getline(lines, line);)
+	{
+		if(result.size() % 8 == 7)
+			erase_if(line, [](char character) { return isdigit(character); });
+
+		result.push_back(line);
+	}
+
+	return result;
+}
+
+TEST_CASE("differential extractCalibrationValue2")
+{
+	const vector<KernelVariant> variants{ { "extractCalibrationValue2SinglePass", kernelOutcome(extractCalibrationValue2SinglePass) } };
+
+	const optional<KernelDivergence> divergence = findKernelDivergence(generateDifferentialCalibrationLines,
+	                                                                   kernelOutcome(extractCalibrationValue2),
+	                                                                   variants,
+	                                                                   { 1, 10, 1000 },
+	                                                                   20);
+
+	CHECK_MESSAGE(!divergence.has_value(), (divergence ? divergence->toString() : string()));
 }
 
 #else
 
-class Trebuchet : public PuzzleSolution
+class Trebuchet : public StreamingPuzzleSolution
 {
 private:
+	void startInput() override;
+	void processLine(std::string_view line) override;
+	void generateInput(ostream& stream,
+	                   const InputGeneration& inputGeneration) const override;
 	int answer1() override;
 	int answer2() override;
+
+private:
+	int64_t sum1_ = 0;
+	int64_t sum2_ = 0;
 };
 
-int Trebuchet::answer1()
+void Trebuchet::startInput()
 {
-	int sum = 0;
+	sum1_ = 0;
+	sum2_ = 0;
+}
 
-	for(const auto& line : input())
-		sum += extractCalibrationValue1(line);
+void Trebuchet::processLine(std::string_view line)
+{
+	sum1_ += extractCalibrationValue1(line);
+	sum2_ += extractCalibrationValue2SinglePass(line);
+}
 
-	return sum;
+void Trebuchet::generateInput(ostream& stream,
+                              const InputGeneration& inputGeneration) const
+{
+	generateCalibrationDocument(stream, inputGeneration);
+}
+
+int Trebuchet::answer1()
+{
+	return checkedAnswer(sum1_);
 }
 
 int Trebuchet::answer2()
 {
-	int sum = 0;
+	return checkedAnswer(sum2_);
+}
+
+AOC_REGISTER_PUZZLE_SOLUTION(Trebuchet, "202301");
+
+#if defined(AOC_FUZZ)
+
+// The input is taken as a single line, so a slow one is a benchmark case as
+// it is.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	static FuzzTarget extractCalibrationValue2Target{"extractCalibrationValue2"};
 
-	for(const auto& line : input())
-		sum += extractCalibrationValue2(line);
+	extractCalibrationValue2Target.run(std::string_view(reinterpret_cast<const char*>(data), size),
+	                                   extractCalibrationValue2);
 
-	return sum;
+	return 0;
 }
 
+#elif !defined(AOC_RUNNER)
+
 int main(int argc, char* argv[])
 {
-	return Trebuchet().run((argc > 1) ? argv[1] : "202301.txt");
+	return Trebuchet().run(argc, argv, "202301.txt");
 }
 
 #endif
+
+#endif
@@ -8,8 +8,14 @@
 #define FMT_HEADER_ONLY
 #include "fmt/format.h"
 
+#include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <optional>
+#include <ostream>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace fmt;
@@ -37,10 +43,16 @@ public:
 	int value_;
 };
 
-Number parseNumber(const string& line, size_t& pos)
+// isdigit() of a char, which is undefined for negative values.
+bool isDigit(char character)
+{
+	return isdigit(static_cast<unsigned char>(character));
+}
+
+Number parseNumber(std::string_view line, size_t& pos)
 {
 	AOC_ASSERT((pos >= 0) && (pos < line.size()));
-	AOC_ASSERT(isdigit(line[pos]));
+	AOC_ASSERT(isDigit(line[pos]));
 
 	const size_t startPos{pos};
 
@@ -48,7 +60,7 @@ Number parseNumber(const string& line, size_t& pos)
 
 	++pos;
 	while(pos < line.size())
-		if(isdigit(line[pos]))
+		if(isDigit(line[pos]))
 			++pos;
 		else
 			break;
@@ -57,15 +69,20 @@ Number parseNumber(const string& line, size_t& pos)
 
 	AOC_ASSERT(endPos >= startPos);
 	AOC_ASSERT((endPos >= 0) && (endPos < line.size()));
-	AOC_ASSERT(isdigit(line[endPos]));
+	AOC_ASSERT(isDigit(line[endPos]));
 
 	number.endPos_ = endPos;
 
 	AOC_ASSERT(pos > startPos);
 	AOC_ASSERT((pos >= 1) && (pos <= line.size()));
-	AOC_ASSERT(!isdigit(line[pos]));
+	AOC_ASSERT((pos == line.size()) || !isDigit(line[pos]));
+
+	const auto [end, error] = from_chars(line.data() + startPos, line.data() + pos, number.value_);
 
-	number.value_ = stoi(string(line, startPos, pos - startPos));
+	if(error == errc::result_out_of_range)
+		panic(format("number too large: '{}'", line.substr(startPos, pos - startPos)));
+
+	AOC_ASSERT((error == errc()) && (end == line.data() + pos));
 
 	return number;
 }
@@ -90,7 +107,7 @@ public:
 
 class EngineSchematicRow
 {
-	friend EngineSchematicRow parseEngineSchematicRow(const string& line);
+	friend EngineSchematicRow parseEngineSchematicRow(std::string_view line);
 
 public:
 	size_t numNumbers() const { return numbers_.size(); }
@@ -156,7 +173,7 @@ string EngineSchematicRow::toString() const
 	return result;
 }
 
-EngineSchematicRow parseEngineSchematicRow(const string& line)
+EngineSchematicRow parseEngineSchematicRow(std::string_view line)
 {
 	EngineSchematicRow row{line.size()};
 
@@ -173,7 +190,7 @@ EngineSchematicRow parseEngineSchematicRow(const string& line)
 			if(pos == string::npos)
 				break;
 		}
-		else if(isdigit(line[pos]))
+		else if(isDigit(line[pos]))
 		{
 			row.numbers_.push_back(parseNumber(line, pos));
 
@@ -196,7 +213,8 @@ EngineSchematicRow parseEngineSchematicRow(const string& line)
 
 class EngineSchematic
 {
-	friend EngineSchematic parseEngineSchematic(const vector<string>& lines);
+	friend EngineSchematic parseEngineSchematic(const LineArena& lines,
+	                                            size_t numTasks);
 
 public:
 	EngineSchematic() = default;
@@ -206,8 +224,9 @@ public:
 	const EngineSchematicRow& row(size_t index) const;
 
 public:
-	int sumPartNumbers() const;
-	int sumGearRatios() const;
+	int64_t sumPartNumbers() const;
+	int64_t sumGearRatios() const;
+	int64_t sumGearRatiosByGear() const;
 	string toString() const;
 
 private:
@@ -225,7 +244,7 @@ private:
 	                  size_t numberIndex) const;
 	bool isGear(size_t rowIndex,
 	            size_t symbolIndex,
-	            int& gearRatio) const;
+	            int64_t& gearRatio) const;
 
 private:
 	size_t width_;
@@ -239,9 +258,9 @@ const EngineSchematicRow& EngineSchematic::row(size_t index) const
 	return rows_[index];
 }
 
-int EngineSchematic::sumPartNumbers() const
+int64_t EngineSchematic::sumPartNumbers() const
 {
-	int sum = 0;
+	int64_t sum = 0;
 
 	for(size_t rowIndex=0; rowIndex<numRows(); ++rowIndex)
 		for(size_t numberIndex=0; numberIndex<row(rowIndex).numNumbers(); ++numberIndex)
@@ -251,15 +270,15 @@ int EngineSchematic::sumPartNumbers() const
 	return sum;
 }
 
-int EngineSchematic::sumGearRatios() const
+int64_t EngineSchematic::sumGearRatios() const
 {
-	int sum = 0;
+	int64_t sum = 0;
 
 	for(size_t rowIndex=0; rowIndex<numRows(); ++rowIndex)
 	{
 		for(size_t symbolIndex=0; symbolIndex<row(rowIndex).numSymbols(); ++symbolIndex)
 		{
-			int gearRatio = 0;
+			int64_t gearRatio = 0;
 
 			if(isGear(rowIndex, symbolIndex, gearRatio))
 				sum += gearRatio;
@@ -269,6 +288,46 @@ int EngineSchematic::sumGearRatios() const
 	return sum;
 }
 
+// Same as sumGearRatios(), but only looks at the numbers around each '*':
+// a number next to a symbol is a part number anyway, so isPartNumber() need
+// not be asked, and as the numbers of a row are ordered by position, the
+// search of a row stops at the first number past the symbol.
+int64_t EngineSchematic::sumGearRatiosByGear() const
+{
+	int64_t sum = 0;
+
+	for(size_t rowIndex=0; rowIndex<numRows(); ++rowIndex)
+	{
+		for(const auto& symbol : row(rowIndex).symbols())
+		{
+			if(symbol.value_ != '*')
+				continue;
+
+			int adjacentNumberCount = 0;
+			int64_t product = 1;
+
+			for(size_t adjacentRowIndex=(rowIndex > 0) ? rowIndex - 1 : 0; adjacentRowIndex<=min(rowIndex + 1, numRows() - 1); ++adjacentRowIndex)
+			{
+				for(const auto& number : row(adjacentRowIndex).numbers())
+				{
+					if(number.startPos_ > symbol.pos_ + 1)
+						break;
+
+					// Only gears with two numbers count, so the product of
+					// more would only risk overflowing.
+					if((symbol.pos_ <= number.endPos_ + 1) && (++adjacentNumberCount <= 2))
+						product *= number.value_;
+				}
+			}
+
+			if(adjacentNumberCount == 2)
+				sum += product;
+		}
+	}
+
+	return sum;
+}
+
 string EngineSchematic::toString() const
 {
 	string result;
@@ -289,7 +348,7 @@ bool EngineSchematic::isNumberAdjacentToSymbol(const Number& number,
                                                int dy) const
 {
 	const auto numberRangeStart = (number.startPos_ > 0) ? (number.startPos_ - 1)
-	                                                     :  number.startPos_ + 1;
+	                                                     :  number.startPos_;
 	const auto numberRangeEnd = number.endPos_ + 1;
 
 	switch(dy)
@@ -336,7 +395,7 @@ bool EngineSchematic::isPartNumber(size_t rowIndex,
 
 bool EngineSchematic::isGear(size_t rowIndex,
                              size_t symbolIndex,
-                             int& gearRatio) const
+                             int64_t& gearRatio) const
 {
 	const Symbol& symbol = row(rowIndex).symbol(symbolIndex);
 
@@ -344,7 +403,7 @@ bool EngineSchematic::isGear(size_t rowIndex,
 		return false;
 
 	int adjacentNumberCount = 0;
-	int product = 1;
+	int64_t product = 1;
 
 	if(rowIndex > 0)
 	{
@@ -410,16 +469,72 @@ bool EngineSchematic::isGear(size_t rowIndex,
 	return false;
 }
 
-EngineSchematic parseEngineSchematic(const vector<string>& lines)
+// Parses the rows in numTasks bands in parallel.
+EngineSchematic parseEngineSchematic(const LineArena& lines,
+                                     size_t numTasks)
 {
 	EngineSchematic engineSchematic{lines.size()};
 
-	for(const auto& line : lines)
-		engineSchematic.rows_.push_back(parseEngineSchematicRow(line));
+	engineSchematic.rows_ = parseLines(lines, parseEngineSchematicRow, numTasks);
 
 	return engineSchematic;
 }
 
+EngineSchematic parseEngineSchematic(const LineArena& lines)
+{
+	return parseEngineSchematic(lines, numParallelTasks(lines.text().size()));
+}
+
+// Writes a size x size schematic. Where a number may start (not right after
+// another one), a cell starts a 1-3 digit number with probability
+// "numberDensity" (0.07 by default), or else holds a symbol with
+// probability "symbolDensity" (0.04 by default), half of which are '*' as
+// in the real input; all other cells are '.'.
+void generateEngineSchematic(ostream& stream,
+                             const InputGeneration& inputGeneration)
+{
+	constexpr std::string_view otherSymbols = "#$%&+-/=@";
+
+	const double numberDensity = inputGeneration.parameter("numberDensity", 0.07);
+	const double symbolDensity = inputGeneration.parameter("symbolDensity", 0.04);
+
+	InputRandom random{inputGeneration.seed_};
+	GeneratedInputWriter writer{stream};
+
+	for(size_t rowIndex=0; rowIndex<inputGeneration.size_; ++rowIndex)
+	{
+		bool afterNumber = false;
+
+		for(size_t columnIndex=0; columnIndex<inputGeneration.size_;)
+		{
+			if(!afterNumber && random.chance(numberDensity))
+			{
+				const size_t numDigits = min<size_t>(random.uniform(1, 3), inputGeneration.size_ - columnIndex);
+
+				writer.put(static_cast<char>(random.uniform('1', '9')));
+
+				for(size_t digitIndex=1; digitIndex<numDigits; ++digitIndex)
+					writer.put(static_cast<char>(random.uniform('0', '9')));
+
+				columnIndex += numDigits;
+				afterNumber = true;
+
+				continue;
+			}
+
+			if(random.chance(symbolDensity))
+				writer.put(random.chance(0.5) ? '*' : otherSymbols[random.uniform(0, otherSymbols.size() - 1)]);
+			else
+				writer.put('.');
+
+			++columnIndex;
+			afterNumber = false;
+		}
+
+		writer.put('\n');
+	}
+}
+
 #ifdef AOC_TEST_SOLUTION
 
 TEST_CASE("parseNumber")
@@ -452,6 +567,17 @@ TEST_CASE("parseNumber")
 
 	CHECK(parseNumber(line4, pos) == Number{9, 9, 1});
 	CHECK(pos == 10);
+
+	string line5{"2147483647.0002147483648"};
+	pos = 0;
+
+	CHECK(parseNumber(line5, pos) == Number{0, 9, 2147483647});
+	CHECK(pos == 10);
+
+	pos = 11;
+
+	CHECK_THROWS_WITH_AS(parseNumber(line5, pos), "number too large: '0002147483648'", runtime_error);
+	CHECK_THROWS_WITH_AS(parseEngineSchematicRow("..12345678901234567890.."), "number too large: '12345678901234567890'", runtime_error);
 }
 
 TEST_CASE("parseEngineSchematicRow")
@@ -474,21 +600,22 @@ TEST_CASE("parseEngineSchematicRow")
 	CHECK(parseEngineSchematicRow("......755.").toString() == "......755.");
 	CHECK(parseEngineSchematicRow("...$.*....").toString() == "...$.*....");
 	CHECK(parseEngineSchematicRow(".664.598..").toString() == ".664.598..");
+	CHECK(parseEngineSchematicRow("\xb2.\xe9").toString() == "\xb2.\xe9");
 }
 
 TEST_CASE("parseEngineSchematic")
 {
-	const vector<string> lines1;
+	const LineArena lines1;
 	const char* engineSchematicStr1 = "";
 
 	CHECK(parseEngineSchematic(lines1).toString() == string(engineSchematicStr1));
 
-	const vector<string> lines2 = { "617*......" };
+	const LineArena lines2 = { "617*......" };
 	const char* engineSchematicStr2 = "617*......";
 
 	CHECK(parseEngineSchematic(lines2).toString() == string(engineSchematicStr2));
 
-	const vector<string> lines3 =
+	const LineArena lines3 =
 	{
 		"617*......",
 		".....+.58."
@@ -500,7 +627,7 @@ TEST_CASE("parseEngineSchematic")
 
 	CHECK(parseEngineSchematic(lines3).toString() == string(engineSchematicStr3));
 
-	const vector<string> lines4 =
+	const LineArena lines4 =
 	{
 		"467..114..",
 		"...*......",
@@ -531,7 +658,7 @@ TEST_CASE("parseEngineSchematic")
 
 TEST_CASE("EngineSchematic")
 {
-	const vector<string> lines =
+	const LineArena lines =
 	{
 	//   0123456789
 		"467..114..", //  0
@@ -584,7 +711,7 @@ TEST_CASE("EngineSchematic")
 
 	SUBCASE("isGear")
 	{
-		int gearRatio = 0;
+		int64_t gearRatio = 0;
 		CHECK(engineSchematic.isGear(1, 0, gearRatio) == true);
 		CHECK(gearRatio == 16345);
 
@@ -609,15 +736,123 @@ TEST_CASE("EngineSchematic")
 	SUBCASE("sumGearRatios")
 	{
 		CHECK(engineSchematic.sumGearRatios() == 467835);
+		CHECK(engineSchematic.sumGearRatiosByGear() == 467835);
+	}
+
+	SUBCASE("numbers in the first column")
+	{
+		const EngineSchematic engineSchematic2 = parseEngineSchematic(LineArena{ "2..", "*..", "3.." });
+
+		CHECK(engineSchematic2.isPartNumber(0, 0) == true);
+		CHECK(engineSchematic2.sumPartNumbers() == 5);
+		CHECK(engineSchematic2.sumGearRatios() == 6);
+		CHECK(engineSchematic2.sumGearRatiosByGear() == 6);
+	}
+
+	SUBCASE("sums larger than an int")
+	{
+		const EngineSchematic engineSchematic2 = parseEngineSchematic(LineArena{ "99999*99999" });
+
+		CHECK(engineSchematic2.sumPartNumbers() == 199998);
+		CHECK(engineSchematic2.sumGearRatios() == 9999800001);
+		CHECK(engineSchematic2.sumGearRatiosByGear() == 9999800001);
+		CHECK_THROWS_WITH_AS(checkedAnswer(engineSchematic2.sumGearRatiosByGear()), "answer does not fit an int: 9999800001", runtime_error);
+	}
+
+	SUBCASE("parseEngineSchematic with tasks")
+	{
+		for(size_t numTasks=1; numTasks<=4; ++numTasks)
+			CHECK(parseEngineSchematic(lines, numTasks).toString() == engineSchematic.toString());
 	}
 }
 
+TEST_CASE("generateEngineSchematic")
+{
+	const auto generate = [](size_t size, uint64_t seed, vector<pair<string, double>> parameters = {})
+	{
+		ostringstream stream;
+		generateEngineSchematic(stream, { size, seed, parameters });
+		return stream.str();
+	};
+
+	CHECK(generate(0, 1).empty());
+	CHECK(generate(140, 1) == generate(140, 1));
+	CHECK(generate(140, 1) != generate(140, 2));
+	CHECK(generate(3, 1, { { "numberDensity", 0.0 }, { "symbolDensity", 0.0 } }) == "...\n...\n...\n");
+
+	const string text = generate(140, 1);
+	const LineArena lines(text);
+	const EngineSchematic engineSchematic = parseEngineSchematic(lines);
+
+	REQUIRE(lines.size() == 140);
+
+	for(const std::string_view line : lines)
+		CHECK(line.size() == 140);
+
+	size_t numNumbers = 0;
+	size_t numSymbols = 0;
+
+	for(size_t rowIndex=0; rowIndex<engineSchematic.numRows(); ++rowIndex)
+	{
+		numNumbers += engineSchematic.row(rowIndex).numNumbers();
+		numSymbols += engineSchematic.row(rowIndex).numSymbols();
+	}
+
+	CHECK(numNumbers > 1000);
+	CHECK(numNumbers < 1400);
+	CHECK(numSymbols > 600);
+	CHECK(numSymbols < 900);
+	CHECK(count(text.begin(), text.end(), '*') > numSymbols / 3);
+	CHECK(engineSchematic.sumPartNumbers() > 0);
+	CHECK(engineSchematic.sumGearRatios() > 0);
+}
+
+vector<string> generateDifferentialEngineSchematic(const InputGeneration& inputGeneration)
+{
+	ostringstream stream;
+	generateEngineSchematic(stream, inputGeneration);
+
+	return { stream.str() };
+}
+
+TEST_CASE("differential sumGearRatios")
+{
+	const vector<KernelVariant> variants
+	{
+		{ "sumGearRatiosByGear", kernelOutcome([](std::string_view text)
+		                         {
+		                             return parseEngineSchematic(LineArena(string(text))).sumGearRatiosByGear();
+		                         }) },
+		{ "parseEngineSchematic (3 tasks)", kernelOutcome([](std::string_view text)
+		                                    {
+		                                        return parseEngineSchematic(LineArena(string(text)), 3).sumGearRatios();
+		                                    }) }
+	};
+
+	const optional<KernelDivergence> divergence = findKernelDivergence(generateDifferentialEngineSchematic,
+	                                                                   kernelOutcome([](std::string_view text)
+	                                                                   {
+	                                                                       return parseEngineSchematic(LineArena(string(text))).sumGearRatios();
+	                                                                   }),
+	                                                                   variants,
+	                                                                   { 0, 1, 2, 3, 10, 140 },
+	                                                                   10);
+
+	CHECK_MESSAGE(!divergence.has_value(), (divergence ? divergence->toString() : string()));
+}
+
 #else
 
 class GearRatios : public PuzzleSolution
 {
+public:
+	GearRatios() : PuzzleSolution(InputLoading::MemoryMapped, AnswerEvaluation::Concurrent) {}
+
 private:
 	void processInput(const string& puzzleInputFilePath) override;
+	void processText(string text) override;
+	void generateInput(ostream& stream,
+	                   const InputGeneration& inputGeneration) const override;
 	int answer1() override;
 	int answer2() override;
 
@@ -632,19 +867,72 @@ void GearRatios::processInput(const string& puzzleInputFilePath)
 	engineSchematic_ = parseEngineSchematic(input());
 }
 
+void GearRatios::processText(string text)
+{
+	PuzzleSolution::processText(std::move(text));
+
+	engineSchematic_ = parseEngineSchematic(input());
+}
+
+void GearRatios::generateInput(ostream& stream,
+                               const InputGeneration& inputGeneration) const
+{
+	generateEngineSchematic(stream, inputGeneration);
+}
+
 int GearRatios::answer1()
 {
-	return engineSchematic_.sumPartNumbers();
+	return checkedAnswer(engineSchematic_.sumPartNumbers());
 }
 
 int GearRatios::answer2()
 {
-	return engineSchematic_.sumGearRatios();
+	return checkedAnswer(engineSchematic_.sumGearRatiosByGear());
+}
+
+AOC_REGISTER_PUZZLE_SOLUTION(GearRatios, "202303");
+
+#if defined(AOC_FUZZ)
+
+// The input is taken as a single row, which parseNumber() is also run on at
+// the start of every number.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	static FuzzTarget parseEngineSchematicRowTarget{"parseEngineSchematicRow"};
+	static FuzzTarget parseNumberTarget{"parseNumber"};
+
+	const std::string_view line(reinterpret_cast<const char*>(data), size);
+
+	parseEngineSchematicRowTarget.run(line, [](std::string_view line)
+	{
+		return parseEngineSchematicRow(line).numNumbers();
+	});
+
+	parseNumberTarget.run(line, [](std::string_view line)
+	{
+		int sum = 0;
+
+		for(size_t pos=0; pos<line.size();)
+		{
+			if(isDigit(line[pos]))
+				sum += parseNumber(line, pos).value_;
+			else
+				++pos;
+		}
+
+		return sum;
+	});
+
+	return 0;
 }
 
+#elif !defined(AOC_RUNNER)
+
 int main(int argc, char* argv[])
 {
-	return GearRatios().run((argc > 1) ? argv[1] : "202303.txt");
+	return GearRatios().run(argc, argv, "202303.txt");
 }
 
 #endif
+
+#endif
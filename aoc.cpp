@@ -8,8 +8,56 @@
 #define FMT_HEADER_ONLY
 #include "fmt/format.h"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#include <sys/stat.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(AOC_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
 
 using namespace fmt;
 using namespace std;
@@ -32,57 +80,4644 @@ namespace aoc
 		return input;
 	}
 
-	[[noreturn]] void panic(const string& message,
-	                        source_location sourceLocation)
+	MappedFile::MappedFile(const string& filePath)
 	{
-#if defined(AOC_TEST) || defined(AOC_TEST_SOLUTION)
-		throw runtime_error(message);
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(filePath.c_str(),
+		                          GENERIC_READ,
+		                          FILE_SHARE_READ,
+		                          nullptr,
+		                          OPEN_EXISTING,
+		                          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		                          nullptr);
+
+		if(file == INVALID_HANDLE_VALUE)
+			panic(format("unable to open input file: \"{}\"", filePath));
+
+		LARGE_INTEGER fileSize;
+
+		if(!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			panic(format("unable to query size of input file: \"{}\"", filePath));
+		}
+
+		size_ = static_cast<size_t>(fileSize.QuadPart);
+
+		if(size_ > 0)
+		{
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if(mapping != nullptr)
+			{
+				data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				CloseHandle(mapping);
+			}
+
+			if(data_ == nullptr)
+			{
+				CloseHandle(file);
+				panic(format("unable to map input file: \"{}\"", filePath));
+			}
+		}
+
+		CloseHandle(file);
 #else
-		constexpr fmt::string_view panicMessageFormat = "`{}` panicked at {}({}:{}) with message: `{}`.";
+		const int fd = open(filePath.c_str(), O_RDONLY);
 
-		println(stderr,
-		        panicMessageFormat,
-		        sourceLocation.function_name(),
-		        sourceLocation.file_name(),
-		        sourceLocation.line(),
-		        sourceLocation.column(),
-		        message);
+		if(fd == -1)
+			panic(format("unable to open input file: \"{}\"", filePath));
 
-		exit(EXIT_FAILURE);
+		struct stat fileStat;
+
+		if(fstat(fd, &fileStat) == -1)
+		{
+			close(fd);
+			panic(format("unable to query size of input file: \"{}\"", filePath));
+		}
+
+		size_ = static_cast<size_t>(fileStat.st_size);
+
+		// mmap() rejects zero-length mappings, an empty file is represented
+		// by an empty view instead.
+		if(size_ > 0)
+		{
+			void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if(data == MAP_FAILED)
+			{
+				close(fd);
+				panic(format("unable to map input file: \"{}\"", filePath));
+			}
+
+			madvise(data, size_, MADV_SEQUENTIAL);
+
+			data_ = static_cast<const char*>(data);
+		}
+
+		close(fd);
 #endif
 	}
 
-	int PuzzleSolution::run(const string& puzzleInputFilePath)
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: data_(exchange(other.data_, nullptr))
+		, size_(exchange(other.size_, 0))
+	{
+	}
+
+	MappedFile::~MappedFile()
 	{
-		processInput(puzzleInputFilePath);
+		unmap();
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if(this != &other)
+		{
+			unmap();
 
-		println("{}", answer1());
-		println("{}", answer2());
+			data_ = exchange(other.data_, nullptr);
+			size_ = exchange(other.size_, 0);
+		}
 
-		return EXIT_SUCCESS;
+		return *this;
 	}
 
-	void PuzzleSolution::processInput(const string& puzzleInputFilePath)
+	void MappedFile::unmap()
 	{
-		input_ = loadPuzzleInput(puzzleInputFilePath);
+		if(data_ == nullptr)
+			return;
+
+#if defined(_WIN32)
+		UnmapViewOfFile(data_);
+#else
+		munmap(const_cast<char*>(data_), size_);
+#endif
+
+		data_ = nullptr;
+		size_ = 0;
 	}
-}
 
-#if defined(AOC_TEST)
+	static atomic<unsigned> numWorkerThreads_{max(thread::hardware_concurrency(), 1U)};
 
-namespace aoc
-{
-	TEST_CASE("isInRange")
+	unsigned numWorkerThreads()
 	{
-		CHECK(isInRange(1, 1, 10) == true);
-		CHECK(isInRange(5, 1, 10) == true);
-		CHECK(isInRange(10, 1, 10) == true);
-		CHECK(isInRange(0, 1, 10) == false);
-		CHECK(isInRange(11, 1, 10) == false);
-		CHECK(isInRange(-10, 1, 10) == false);
-		CHECK(isInRange(20, 1, 10) == false);
-		CHECK(isInRange(3, -1, 3) == true);
+		return numWorkerThreads_;
+	}
+
+	void setNumWorkerThreads(unsigned numThreads)
+	{
+		AOC_ASSERT(numThreads > 0);
+
+		numWorkerThreads_ = numThreads;
+	}
+
+	size_t numParallelTasks(size_t numBytes)
+	{
+		constexpr size_t minNumBytesPerTask = 1 << 20;
+
+		return clamp<size_t>(numBytes / minNumBytesPerTask, 1, numWorkerThreads());
+	}
+
+	vector<std::string_view> splitIntoLineAlignedRanges(std::string_view text,
+	                                                    size_t numRanges)
+	{
+		AOC_ASSERT(numRanges > 0);
+
+		vector<std::string_view> ranges;
+
+		ranges.reserve(numRanges);
+
+		size_t rangeStartPos = 0;
+
+		for(size_t i=1; i<=numRanges; ++i)
+		{
+			size_t rangeEndPos = text.size();
+
+			if(i < numRanges)
+			{
+				// Ends the range at the first line starting at or after its nominal end.
+				const size_t nominalEndPos = text.size() * i / numRanges;
+				const size_t newlinePos = text.find('\n', max(rangeStartPos, (nominalEndPos > 0) ? (nominalEndPos - 1) : 0));
+
+				if(newlinePos != std::string_view::npos)
+					rangeEndPos = newlinePos + 1;
+			}
+
+			ranges.push_back(text.substr(rangeStartPos, rangeEndPos - rangeStartPos));
+
+			rangeStartPos = rangeEndPos;
+		}
+
+		return ranges;
+	}
+
+	InstructionSet detectInstructionSet()
+	{
+#if defined(AOC_X86)
+#if defined(_MSC_VER)
+		int cpuInfo[4];
+
+		__cpuid(cpuInfo, 0);
+
+		if(cpuInfo[0] >= 7)
+		{
+			__cpuid(cpuInfo, 1);
+
+			const bool osUsesXsave = (cpuInfo[2] & (1 << 27)) != 0;
+
+			__cpuidex(cpuInfo, 7, 0);
+
+			const bool avx2Supported = (cpuInfo[1] & (1 << 5)) != 0;
+
+			if(osUsesXsave && avx2Supported && ((_xgetbv(0) & 0x6) == 0x6))
+				return InstructionSet::Avx2;
+		}
+
+		return InstructionSet::Sse2;
+#else
+		__builtin_cpu_init();
+
+		if(__builtin_cpu_supports("avx2"))
+			return InstructionSet::Avx2;
+
+		if(__builtin_cpu_supports("sse2"))
+			return InstructionSet::Sse2;
+#endif
+#endif
+
+		return InstructionSet::Scalar;
+	}
+
+	std::string_view instructionSetName(InstructionSet instructionSet)
+	{
+		switch(instructionSet)
+		{
+			case InstructionSet::Scalar: return "scalar";
+			case InstructionSet::Sse2: return "SSE2";
+			case InstructionSet::Avx2: return "AVX2";
+		}
+
+		panic(format("invalid instruction set: {}", static_cast<int>(instructionSet)));
+	}
+
+	// Each indexNewlines*() function appends the offset following every
+	// newline in text to lineOffsets. The vectorised variants process whole
+	// blocks only and return the position of the first unprocessed byte.
+	// They count the newlines first, so the offset table is allocated once
+	// and filled without capacity checks.
+	static void indexNewlinesScalar(std::string_view text,
+	                                size_t pos,
+	                                vector<size_t>& lineOffsets)
+	{
+		for(pos = text.find('\n', pos); pos != std::string_view::npos; pos = text.find('\n', pos + 1))
+			lineOffsets.push_back(pos + 1);
+	}
+
+#if defined(AOC_X86)
+	AOC_TARGET("sse2")
+	static unsigned newlineMaskSse2(const char* block)
+	{
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))));
+	}
+
+	AOC_TARGET("sse2")
+	static size_t indexNewlinesSse2(std::string_view text,
+	                                vector<size_t>& lineOffsets)
+	{
+		const size_t size = text.size() - (text.size() % sizeof(__m128i));
+
+		size_t numNewlines = 0;
+
+		for(size_t pos=0; pos<size; pos+=sizeof(__m128i))
+			numNewlines += popcount(newlineMaskSse2(text.data() + pos));
+
+		const size_t numLineOffsets = lineOffsets.size();
+
+		lineOffsets.resize(numLineOffsets + numNewlines);
+
+		size_t* lineOffset = lineOffsets.data() + numLineOffsets;
+
+		for(size_t pos=0; pos<size; pos+=sizeof(__m128i))
+			for(unsigned mask = newlineMaskSse2(text.data() + pos); mask != 0; mask &= mask - 1)
+				*lineOffset++ = pos + countr_zero(mask) + 1;
+
+		return size;
+	}
+
+	AOC_TARGET("avx2")
+	static unsigned newlineMaskAvx2(const char* block)
+	{
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+
+		return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'))));
+	}
+
+	AOC_TARGET("avx2")
+	static size_t indexNewlinesAvx2(std::string_view text,
+	                                vector<size_t>& lineOffsets)
+	{
+		const size_t size = text.size() - (text.size() % sizeof(__m256i));
+
+		size_t numNewlines = 0;
+
+		for(size_t pos=0; pos<size; pos+=sizeof(__m256i))
+			numNewlines += popcount(newlineMaskAvx2(text.data() + pos));
+
+		const size_t numLineOffsets = lineOffsets.size();
+
+		lineOffsets.resize(numLineOffsets + numNewlines);
+
+		size_t* lineOffset = lineOffsets.data() + numLineOffsets;
+
+		for(size_t pos=0; pos<size; pos+=sizeof(__m256i))
+			for(unsigned mask = newlineMaskAvx2(text.data() + pos); mask != 0; mask &= mask - 1)
+				*lineOffset++ = pos + countr_zero(mask) + 1;
+
+		return size;
+	}
+#endif
+
+	vector<size_t> indexLines(std::string_view text)
+	{
+		return indexLinesInParallel(text, numParallelTasks(text.size()));
+	}
+
+	vector<size_t> indexLines(std::string_view text,
+	                          InstructionSet instructionSet)
+	{
+		vector<size_t> lineOffsets{0};
+
+		size_t pos = 0;
+
+		switch(instructionSet)
+		{
+			case InstructionSet::Scalar:
+				break;
+
+#if defined(AOC_X86)
+			case InstructionSet::Sse2:
+				pos = indexNewlinesSse2(text, lineOffsets);
+				break;
+
+			case InstructionSet::Avx2:
+				pos = indexNewlinesAvx2(text, lineOffsets);
+				break;
+#else
+			default:
+				panic(format("unsupported instruction set: {}", instructionSetName(instructionSet)));
+#endif
+		}
+
+		indexNewlinesScalar(text, pos, lineOffsets);
+
+		if(!text.empty() && (text.back() != '\n'))
+			lineOffsets.push_back(text.size() + 1);
+
+		return lineOffsets;
+	}
+
+	vector<size_t> indexLinesInParallel(std::string_view text,
+	                                    size_t numTasks)
+	{
+		static const InstructionSet instructionSet = detectInstructionSet();
+
+		if(numTasks <= 1)
+			return indexLines(text, instructionSet);
+
+		const vector<std::string_view> ranges = splitIntoLineAlignedRanges(text, numTasks);
+		vector<vector<size_t>> rangeLineOffsets(numTasks);
+
+		parallelFor(numTasks, [&](size_t taskIndex)
+		{
+			rangeLineOffsets[taskIndex] = indexLines(ranges[taskIndex], instructionSet);
+		});
+
+		// Every range but the last one ends with a newline, so its final offset
+		// is the start of the next range and is left for that range to emit.
+		vector<size_t> lineOffsetPositions(numTasks + 1, 1);
+
+		for(size_t i=0; i<numTasks; ++i)
+			lineOffsetPositions[i + 1] = lineOffsetPositions[i] + rangeLineOffsets[i].size() - 1;
+
+		vector<size_t> lineOffsets(lineOffsetPositions.back());
+
+		parallelFor(numTasks, [&](size_t taskIndex)
+		{
+			const size_t rangeStartPos = static_cast<size_t>(ranges[taskIndex].data() - text.data());
+
+			transform(rangeLineOffsets[taskIndex].begin() + 1,
+			          rangeLineOffsets[taskIndex].end(),
+			          lineOffsets.begin() + lineOffsetPositions[taskIndex],
+			          [=](size_t lineOffset) { return rangeStartPos + lineOffset; });
+		});
+
+		return lineOffsets;
+	}
+
+	LineArena::LineArena(string text)
+		: buffer_(std::move(text))
+		, lineOffsets_(indexLines(buffer_))
+	{
+	}
+
+	LineArena::LineArena(MappedFile file)
+		: file_(std::move(file))
+		, lineOffsets_(indexLines(file_.view()))
+	{
+	}
+
+	LineArena::LineArena(initializer_list<std::string_view> lines)
+		: lineOffsets_{0}
+	{
+		for(const auto& line : lines)
+		{
+			AOC_ASSERT(line.find('\n') == std::string_view::npos);
+
+			buffer_ += line;
+			buffer_ += '\n';
+
+			lineOffsets_.push_back(buffer_.size());
+		}
+	}
+
+	std::string_view LineArena::operator[](size_t index) const
+	{
+		AOC_ASSERT(index < size());
+
+		const size_t lineStartPos = lineOffsets_[index];
+		const size_t lineEndPos = lineOffsets_[index + 1] - 1;
+
+		return text().substr(lineStartPos, lineEndPos - lineStartPos);
+	}
+
+	std::string_view LineArena::text() const
+	{
+		return (file_.data() != nullptr) ? file_.view()
+		                                 : std::string_view(buffer_);
+	}
+
+	size_t LineArena::findFirstLineAtOrAfter(size_t pos) const
+	{
+		return static_cast<size_t>(lower_bound(lineOffsets_.begin(), lineOffsets_.end() - 1, pos) - lineOffsets_.begin());
+	}
+
+	string LineArena::releaseBuffer()
+	{
+		string buffer = std::move(buffer_);
+
+		*this = LineArena();
+
+		return buffer;
+	}
+
+	LineArena loadBufferedPuzzleInput(const string& puzzleInputFilePath)
+	{
+		return loadBufferedPuzzleInput(puzzleInputFilePath, string());
+	}
+
+	LineArena loadBufferedPuzzleInput(const string& puzzleInputFilePath,
+	                                  string buffer)
+	{
+		ifstream fileStream{puzzleInputFilePath, ios::binary};
+
+		if(!fileStream.is_open())
+			panic(format("unable to open input file: \"{}\"", puzzleInputFilePath));
+
+		fileStream.seekg(0, ios::end);
+
+		const streamoff fileSize = fileStream.tellg();
+
+		if(fileSize == -1)
+		{
+			// Pipes and other non-seekable inputs have no size up front, so
+			// they are read in blocks until the end.
+			fileStream.clear();
+
+			constexpr size_t blockSize = 64 << 10;
+
+			buffer.clear();
+
+			for(;;)
+			{
+				const size_t size = buffer.size();
+
+				buffer.resize(size + blockSize);
+				fileStream.read(buffer.data() + size, blockSize);
+				buffer.resize(size + static_cast<size_t>(fileStream.gcount()));
+
+				if(!fileStream)
+					break;
+			}
+
+			if(fileStream.bad())
+				panic(format("unable to read input file: \"{}\"", puzzleInputFilePath));
+
+			return LineArena(std::move(buffer));
+		}
+
+		// Shrinking or growing within the capacity does not reallocate.
+		buffer.resize(static_cast<size_t>(fileSize));
+
+		fileStream.seekg(0);
+		fileStream.read(buffer.data(), buffer.size());
+
+		if(!fileStream)
+			panic(format("unable to read input file: \"{}\"", puzzleInputFilePath));
+
+		return LineArena(std::move(buffer));
+	}
+
+	LineArena loadMappedPuzzleInput(const string& puzzleInputFilePath)
+	{
+		return LineArena(MappedFile(puzzleInputFilePath));
+	}
+
+	ChunkReader::ChunkReader(const string& filePath,
+	                         size_t chunkSize,
+	                         size_t numChunks)
+		: filePath_(filePath)
+		, chunks_(numChunks)
+	{
+		AOC_ASSERT(chunkSize > 0);
+		AOC_ASSERT(numChunks > 0);
+
+#if defined(_WIN32)
+		fileDescriptor_ = _open(filePath.c_str(), _O_RDONLY | _O_BINARY | _O_SEQUENTIAL);
+#else
+		fileDescriptor_ = open(filePath.c_str(), O_RDONLY);
+#endif
+
+		if(fileDescriptor_ == -1)
+			panic(format("unable to open input file: \"{}\"", filePath));
+
+#if defined(__linux__)
+		posix_fadvise(fileDescriptor_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+		// The buffers of a regular file need not be larger than the file, plus
+		// one byte so that the first read already finds its end.
+#if defined(_WIN32)
+		struct _stat64 fileStat;
+
+		if((_fstat64(fileDescriptor_, &fileStat) == 0) && ((fileStat.st_mode & _S_IFMT) == _S_IFREG))
+#else
+		struct stat fileStat;
+
+		if((fstat(fileDescriptor_, &fileStat) == 0) && S_ISREG(fileStat.st_mode))
+#endif
+			chunkSize = min(chunkSize, static_cast<size_t>(fileStat.st_size) + 1);
+
+		for(auto& chunk : chunks_)
+			chunk.data_.resize(chunkSize);
+
+		thread_ = thread(&ChunkReader::readChunks, this);
+	}
+
+	ChunkReader::~ChunkReader()
+	{
+		// Releasing every buffer at once wakes the reader if it is waiting for
+		// one, after which it notices it has been stopped.
+		stopped_ = true;
+		numReleasedChunks_.fetch_add(chunks_.size(), memory_order_release);
+		numReleasedChunks_.notify_one();
+
+		thread_.join();
+
+#if defined(_WIN32)
+		_close(fileDescriptor_);
+#else
+		close(fileDescriptor_);
+#endif
+	}
+
+	std::string_view ChunkReader::nextChunk()
+	{
+		if(chunkAcquired_)
+		{
+			numReleasedChunks_.fetch_add(1, memory_order_release);
+			numReleasedChunks_.notify_one();
+
+			chunkAcquired_ = false;
+		}
+
+		if(endOfFileReached_)
+			return std::string_view();
+
+		const size_t chunkIndex = numReleasedChunks_.load(memory_order_relaxed);
+
+		for(size_t numReadChunks = numReadChunks_.load(memory_order_acquire);
+		    numReadChunks == chunkIndex;
+		    numReadChunks = numReadChunks_.load(memory_order_acquire))
+			numReadChunks_.wait(numReadChunks, memory_order_acquire);
+
+		const Chunk& chunk = chunks_[chunkIndex % chunks_.size()];
+
+		if(chunk.readFailed_)
+			panic(format("unable to read input file: \"{}\"", filePath_));
+
+		// Only the last chunk of the file is not completely filled.
+		endOfFileReached_ = chunk.size_ < chunk.data_.size();
+		chunkAcquired_ = true;
+
+		return std::string_view(chunk.data_.data(), chunk.size_);
 	}
+
+	void ChunkReader::readChunks()
+	{
+		for(size_t chunkIndex=0; ; ++chunkIndex)
+		{
+			for(size_t numReleasedChunks = numReleasedChunks_.load(memory_order_acquire);
+			    chunkIndex >= numReleasedChunks + chunks_.size();
+			    numReleasedChunks = numReleasedChunks_.load(memory_order_acquire))
+				numReleasedChunks_.wait(numReleasedChunks, memory_order_acquire);
+
+			if(stopped_)
+				return;
+
+			Chunk& chunk = chunks_[chunkIndex % chunks_.size()];
+
+			chunk.size_ = 0;
+
+			while(chunk.size_ < chunk.data_.size())
+			{
+				const size_t numBytesToRead = chunk.data_.size() - chunk.size_;
+
+#if defined(_WIN32)
+				const auto numBytesRead = _read(fileDescriptor_, chunk.data_.data() + chunk.size_, static_cast<unsigned>(min<size_t>(numBytesToRead, INT_MAX)));
+#else
+				const auto numBytesRead = read(fileDescriptor_, chunk.data_.data() + chunk.size_, numBytesToRead);
+
+				if((numBytesRead == -1) && (errno == EINTR))
+					continue;
+#endif
+
+				if(numBytesRead <= 0)
+				{
+					chunk.readFailed_ = numBytesRead < 0;
+					break;
+				}
+
+				chunk.size_ += static_cast<size_t>(numBytesRead);
+			}
+
+			const bool lastChunk = chunk.size_ < chunk.data_.size();
+
+			numReadChunks_.store(chunkIndex + 1, memory_order_release);
+			numReadChunks_.notify_one();
+
+			if(lastChunk)
+				return;
+		}
+	}
+
+	static atomic<bool> panicThrows_{false};
+
+	void setPanicThrows(bool panicThrows)
+	{
+		panicThrows_ = panicThrows;
+	}
+
+	[[noreturn]] void panic(const string& message,
+	                        source_location sourceLocation)
+	{
+#if defined(AOC_TEST) || defined(AOC_TEST_SOLUTION)
+		throw runtime_error(message);
+#else
+		if(panicThrows_)
+			throw runtime_error(message);
+
+		constexpr fmt::string_view panicMessageFormat = "`{}` panicked at {}({}:{}) with message: `{}`.";
+
+		println(stderr,
+		        panicMessageFormat,
+		        sourceLocation.function_name(),
+		        sourceLocation.file_name(),
+		        sourceLocation.line(),
+		        sourceLocation.column(),
+		        message);
+
+		exit(EXIT_FAILURE);
+#endif
+	}
+
+	int checkedAnswer(int64_t answer)
+	{
+		if((answer < INT_MIN) || (answer > INT_MAX))
+			panic(format("answer does not fit an int: {}", answer));
+
+		return static_cast<int>(answer);
+	}
+
+	double InputGeneration::parameter(std::string_view name,
+	                                  double defaultValue) const
+	{
+		for(const auto& [parameterName, value] : parameters_)
+			if(parameterName == name)
+				return value;
+
+		return defaultValue;
+	}
+
+	void GeneratedInputWriter::flush()
+	{
+		stream_.write(block_.data(), static_cast<streamsize>(block_.size()));
+		block_.clear();
+	}
+
+	string KernelDivergence::toString() const
+	{
+		constexpr size_t maxShownInputSize = 200;
+
+		return format("{} diverges from the reference on {} bytes of input generated with size {} and seed {}: {:?}{}; expected {}, got {}",
+		              variantName_,
+		              input_.size(),
+		              inputGeneration_.size_,
+		              inputGeneration_.seed_,
+		              std::string_view(input_).substr(0, maxShownInputSize),
+		              (input_.size() > maxShownInputSize) ? "..." : "",
+		              expected_,
+		              actual_);
+	}
+
+	string fuzzSlowestInputsDirectory()
+	{
+		const char* slowestInputsDirectory = getenv("AOC_FUZZ_SLOWEST_DIR");
+
+		return slowestInputsDirectory ? slowestInputsDirectory : ".";
+	}
+
+	FuzzTarget::FuzzTarget(string name,
+	                       string slowestInputsDirectory,
+	                       size_t numSlowestInputs)
+		: name_(std::move(name))
+		, slowestInputsDirectory_(std::move(slowestInputsDirectory))
+		, numSlowestInputs_(numSlowestInputs)
+	{
+		AOC_ASSERT(numSlowestInputs_ > 0);
+
+		// Panics reject inputs rather than ending the fuzzer.
+		setPanicThrows(true);
+	}
+
+	FuzzTarget::~FuzzTarget()
+	{
+		if(numRuns_ == 0)
+			return;
+
+		println(stderr, "{}: {} runs, mean {:.0f} ns, slowest {} ns",
+		        name_,
+		        numRuns_,
+		        chrono::duration<double, nano>(totalDuration_).count() / numRuns_,
+		        chrono::duration_cast<chrono::nanoseconds>(slowestInputs_.front().duration_).count());
+	}
+
+	bool FuzzTarget::slowEnough(Duration duration) const
+	{
+		return (slowestInputs_.size() < numSlowestInputs_) || (duration > slowestInputs_.back().duration_);
+	}
+
+	void FuzzTarget::record(std::string_view input,
+	                        Duration duration)
+	{
+		for(const SlowInput& slowInput : slowestInputs_)
+			if(slowInput.input_ == input)
+				return;
+
+		if(slowestInputs_.size() == numSlowestInputs_)
+			slowestInputs_.pop_back();
+
+		const auto pos = find_if(slowestInputs_.begin(), slowestInputs_.end(), [&](const SlowInput& slowInput)
+		{
+			return slowInput.duration_ < duration;
+		});
+
+		const size_t index = static_cast<size_t>(pos - slowestInputs_.begin());
+
+		slowestInputs_.insert(pos, { string(input), duration });
+
+		// Only the files from the new input's rank on change.
+		for(size_t rank=index; rank<slowestInputs_.size(); ++rank)
+		{
+			const string filePath = (filesystem::path(slowestInputsDirectory_) / format("{}-slowest-{}.txt", name_, rank + 1)).string();
+			ofstream fileStream{filePath, ios::binary | ios::trunc};
+
+			fileStream.write(slowestInputs_[rank].input_.data(), static_cast<streamsize>(slowestInputs_[rank].input_.size()));
+
+			if(!fileStream.flush())
+				panic(format("unable to write slow fuzz input file: \"{}\"", filePath));
+		}
+	}
+
+	void mutateFuzzInput(string& input,
+	                     InputRandom& random,
+	                     size_t maxSize)
+	{
+		switch(input.empty() ? 1 : random.uniform(0, 3))
+		{
+			case 0:
+				input[random.uniform(0, input.size() - 1)] = static_cast<char>(random.uniform(0, 255));
+				break;
+
+			case 1:
+				input.insert(input.begin() + random.uniform(0, input.size()), static_cast<char>(random.uniform(0, 255)));
+				break;
+
+			case 2:
+				input.erase(input.begin() + random.uniform(0, input.size() - 1));
+				break;
+
+			case 3:
+			{
+				const size_t pos = random.uniform(0, input.size() - 1);
+				const string slice = input.substr(pos, random.uniform(1, min<size_t>(input.size() - pos, 16)));
+				const size_t numRepetitions = random.uniform(1, 64);
+
+				for(size_t i=0; i<numRepetitions; ++i)
+					input.insert(pos, slice);
+
+				break;
+			}
+		}
+
+		if(input.size() > maxSize)
+			input.resize(maxSize);
+	}
+
+	static string kernelOutcomeOrPanic(const KernelOutcome& outcome,
+	                                   std::string_view input)
+	{
+		try
+		{
+			return outcome(input);
+		}
+		catch(const exception& exception)
+		{
+			return format("panic: {}", exception.what());
+		}
+	}
+
+	static optional<KernelDivergence> findFirstKernelDivergence(const KernelInputGenerator& generateInputs,
+	                                                            const KernelOutcome& reference,
+	                                                            const vector<KernelVariant>& variants,
+	                                                            const vector<size_t>& sizes,
+	                                                            uint64_t numSeeds)
+	{
+		for(size_t size : sizes)
+		{
+			for(uint64_t seed=0; seed<numSeeds; ++seed)
+			{
+				const InputGeneration inputGeneration{size, seed, {}};
+
+				for(const string& input : generateInputs(inputGeneration))
+				{
+					const string expected = kernelOutcomeOrPanic(reference, input);
+
+					for(const KernelVariant& variant : variants)
+					{
+						string actual = kernelOutcomeOrPanic(variant.outcome_, input);
+
+						if(actual != expected)
+							return KernelDivergence{variant.name_, inputGeneration, input, expected, std::move(actual)};
+					}
+				}
+			}
+		}
+
+		return nullopt;
+	}
+
+	optional<KernelDivergence> findKernelDivergence(const KernelInputGenerator& generateInputs,
+	                                                const KernelOutcome& reference,
+	                                                const vector<KernelVariant>& variants,
+	                                                const vector<size_t>& sizes,
+	                                                uint64_t numSeeds)
+	{
+		// Panics become outcomes to compare rather than ending the process.
+		const bool panicThrows = panicThrows_.exchange(true);
+
+		try
+		{
+			optional<KernelDivergence> divergence = findFirstKernelDivergence(generateInputs, reference, variants, sizes, numSeeds);
+
+			panicThrows_ = panicThrows;
+
+			return divergence;
+		}
+		catch(...)
+		{
+			panicThrows_ = panicThrows;
+
+			throw;
+		}
+	}
+
+	std::string_view phaseName(Phase phase)
+	{
+		switch(phase)
+		{
+			case Phase::Load: return "load";
+			case Phase::Parse: return "parse";
+			case Phase::Answer1: return "answer1";
+			case Phase::Answer2: return "answer2";
+			case Phase::Total: return "total";
+		}
+
+		panic(format("invalid phase: {}", static_cast<int>(phase)));
+	}
+
+	std::string_view counterEventName(CounterEvent counterEvent)
+	{
+		switch(counterEvent)
+		{
+			case CounterEvent::Cycles: return "cycles";
+			case CounterEvent::Instructions: return "instructions";
+			case CounterEvent::CacheReferences: return "cache_references";
+			case CounterEvent::CacheMisses: return "cache_misses";
+			case CounterEvent::Branches: return "branches";
+			case CounterEvent::BranchMisses: return "branch_misses";
+		}
+
+		panic(format("invalid counter event: {}", static_cast<int>(counterEvent)));
+	}
+
+	class ThreadPerformanceCounters
+	{
+	public:
+		ThreadPerformanceCounters();
+		ThreadPerformanceCounters(const ThreadPerformanceCounters&) = delete;
+		~ThreadPerformanceCounters();
+
+	public:
+		ThreadPerformanceCounters& operator=(const ThreadPerformanceCounters&) = delete;
+
+	public:
+		CounterValues read() const;
+		const string& unavailabilityReason() const { return unavailabilityReason_; }
+
+	private:
+		array<int, numCounterEvents> fileDescriptors_;
+		string unavailabilityReason_;
+	};
+
+	ThreadPerformanceCounters::ThreadPerformanceCounters()
+	{
+		fileDescriptors_.fill(-1);
+
+#if defined(__linux__)
+		constexpr uint64_t configs[numCounterEvents] =
+		{
+			PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_REFERENCES,
+			PERF_COUNT_HW_CACHE_MISSES,
+			PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+			PERF_COUNT_HW_BRANCH_MISSES
+		};
+
+		for(size_t counterEvent=0; counterEvent<numCounterEvents; ++counterEvent)
+		{
+			perf_event_attr attributes{};
+
+			attributes.size = sizeof(attributes);
+			attributes.type = PERF_TYPE_HARDWARE;
+			attributes.config = configs[counterEvent];
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+			attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			fileDescriptors_[counterEvent] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+
+			if((fileDescriptors_[counterEvent] == -1) && unavailabilityReason_.empty())
+				unavailabilityReason_ = format("perf_event_open() failed for {}: {}",
+				                               counterEventName(CounterEvent(counterEvent)),
+				                               strerror(errno));
+		}
+#else
+		unavailabilityReason_ = "performance counters are only supported on Linux";
+#endif
+	}
+
+	ThreadPerformanceCounters::~ThreadPerformanceCounters()
+	{
+#if defined(__linux__)
+		for(int fileDescriptor : fileDescriptors_)
+			if(fileDescriptor != -1)
+				close(fileDescriptor);
+#endif
+	}
+
+	CounterValues ThreadPerformanceCounters::read() const
+	{
+		CounterValues counterValues;
+
+		counterValues.fill(numeric_limits<double>::quiet_NaN());
+
+#if defined(__linux__)
+		for(size_t counterEvent=0; counterEvent<numCounterEvents; ++counterEvent)
+		{
+			uint64_t values[3];
+
+			if((fileDescriptors_[counterEvent] == -1) ||
+			   (::read(fileDescriptors_[counterEvent], values, sizeof(values)) != sizeof(values)))
+				continue;
+
+			const auto [value, timeEnabled, timeRunning] = values;
+
+			// A counter which had to share the PMU with others only ran part of
+			// the time and is extrapolated.
+			if(timeRunning > 0)
+				counterValues[counterEvent] = static_cast<double>(value) * timeEnabled / timeRunning;
+		}
+#endif
+
+		return counterValues;
+	}
+
+	static const ThreadPerformanceCounters& threadPerformanceCounters()
+	{
+		thread_local const ThreadPerformanceCounters performanceCounters;
+
+		return performanceCounters;
+	}
+
+	CounterValues readPerformanceCounters()
+	{
+		return threadPerformanceCounters().read();
+	}
+
+	string performanceCountersUnavailabilityReason()
+	{
+		return threadPerformanceCounters().unavailabilityReason();
+	}
+
+	// Counted by the replacement operator new and delete at the end of this
+	// file. Constant-initialised, so allocations made during the dynamic
+	// initialisation of other translation units are counted as well.
+	static atomic<size_t> numTrackedAllocations{0};
+	static atomic<size_t> numTrackedAllocatedBytes{0};
+	static atomic<size_t> numTrackedLiveBytes{0};
+	static atomic<size_t> peakTrackedLiveBytes{0};
+
+	bool allocationTrackingEnabled()
+	{
+#if defined(AOC_TRACK_ALLOCATIONS)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	AllocationStatistics readAllocationStatistics()
+	{
+		return { numTrackedAllocations.load(memory_order_relaxed),
+		         numTrackedAllocatedBytes.load(memory_order_relaxed),
+		         peakTrackedLiveBytes.load(memory_order_relaxed) };
+	}
+
+	size_t resetPeakLiveBytes()
+	{
+		return peakTrackedLiveBytes.exchange(numTrackedLiveBytes.load(memory_order_relaxed), memory_order_relaxed);
+	}
+
+	static void raisePeakLiveBytes(size_t liveBytes)
+	{
+		size_t peakLiveBytes = peakTrackedLiveBytes.load(memory_order_relaxed);
+
+		while((liveBytes > peakLiveBytes) &&
+		      !peakTrackedLiveBytes.compare_exchange_weak(peakLiveBytes, liveBytes, memory_order_relaxed))
+		{
+		}
+	}
+
+	void restorePeakLiveBytes(size_t peakLiveBytes)
+	{
+		raisePeakLiveBytes(peakLiveBytes);
+	}
+
+#if defined(AOC_TRACK_ALLOCATIONS)
+	// Every block starts with a header holding the requested size, so that
+	// unsized operator delete knows how many bytes become free. The header is
+	// as large as the alignment to keep the returned pointer aligned.
+	static size_t allocationHeaderSize(size_t alignment)
+	{
+		return max(alignment, static_cast<size_t>(__STDCPP_DEFAULT_NEW_ALIGNMENT__));
+	}
+
+	static void* allocateTracked(size_t size,
+	                             size_t alignment) noexcept
+	{
+		const size_t headerSize = allocationHeaderSize(alignment);
+		void* block;
+
+		if(alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			block = malloc(headerSize + size);
+		else
+#if defined(_MSC_VER)
+			block = _aligned_malloc(headerSize + size, alignment);
+#else
+			block = aligned_alloc(alignment, (headerSize + size + alignment - 1) / alignment * alignment);
+#endif
+
+		if(!block)
+			return nullptr;
+
+		*static_cast<size_t*>(block) = size;
+
+		numTrackedAllocations.fetch_add(1, memory_order_relaxed);
+		numTrackedAllocatedBytes.fetch_add(size, memory_order_relaxed);
+		raisePeakLiveBytes(numTrackedLiveBytes.fetch_add(size, memory_order_relaxed) + size);
+
+		return static_cast<char*>(block) + headerSize;
+	}
+
+	static void* allocateTrackedOrThrow(size_t size,
+	                                    size_t alignment)
+	{
+		while(true)
+		{
+			if(void* pointer = allocateTracked(size, alignment))
+				return pointer;
+
+			if(const new_handler newHandler = get_new_handler())
+				newHandler();
+			else
+				throw bad_alloc();
+		}
+	}
+
+	static void deallocateTracked(void* pointer,
+	                              size_t alignment) noexcept
+	{
+		if(!pointer)
+			return;
+
+		void* block = static_cast<char*>(pointer) - allocationHeaderSize(alignment);
+
+		numTrackedLiveBytes.fetch_sub(*static_cast<size_t*>(block), memory_order_relaxed);
+
+#if defined(_MSC_VER)
+		if(alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			_aligned_free(block);
+			return;
+		}
+#endif
+
+		free(block);
+	}
+#endif
+
+	void PhaseTimings::addCounters(Phase phase,
+	                               const CounterValues& counters)
+	{
+		for(size_t counterEvent=0; counterEvent<numCounterEvents; ++counterEvent)
+			counters_[static_cast<size_t>(phase)][counterEvent] += counters[counterEvent];
+	}
+
+	bool PhaseTimings::allocationsTracked(Phase phase) const
+	{
+		return allocationsEnabled_ && !(concurrentAnswers_ && ((phase == Phase::Answer1) || (phase == Phase::Answer2)));
+	}
+
+	void PhaseTimings::addAllocations(Phase phase,
+	                                  const AllocationStatistics& allocations)
+	{
+		AllocationStatistics& phaseAllocations = allocations_[static_cast<size_t>(phase)];
+
+		phaseAllocations.numAllocations_ += allocations.numAllocations_;
+		phaseAllocations.numAllocatedBytes_ += allocations.numAllocatedBytes_;
+		phaseAllocations.peakLiveBytes_ = max(phaseAllocations.peakLiveBytes_, allocations.peakLiveBytes_);
+	}
+
+	void PhaseTimings::excludeNestedPhase(Phase phase,
+	                                      Phase nestedPhase)
+	{
+		add(phase, -duration(nestedPhase));
+
+		CounterValues nestedCounters = counters(nestedPhase);
+
+		for(double& nestedCounter : nestedCounters)
+			nestedCounter = -nestedCounter;
+
+		addCounters(phase, nestedCounters);
+
+		// A high-water mark cannot be split, so the peak keeps covering the
+		// nested phase.
+		AllocationStatistics& phaseAllocations = allocations_[static_cast<size_t>(phase)];
+
+		phaseAllocations.numAllocations_ -= allocations(nestedPhase).numAllocations_;
+		phaseAllocations.numAllocatedBytes_ -= allocations(nestedPhase).numAllocatedBytes_;
+	}
+
+	static constexpr std::string_view answersInParsePhaseNote = "the answers are computed in the parse phase; answer1 and answer2 only return them";
+
+	void PhaseTimings::reset()
+	{
+		durations_ = {};
+		counters_ = {};
+		allocations_ = {};
+	}
+
+	static double counterRatio(const CounterValues& counters,
+	                           CounterEvent numerator,
+	                           CounterEvent denominator)
+	{
+		const double denominatorValue = counters[static_cast<size_t>(denominator)];
+
+		return (denominatorValue > 0.0) ? counters[static_cast<size_t>(numerator)] / denominatorValue
+		                                : numeric_limits<double>::quiet_NaN();
+	}
+
+	string PhaseTimings::toString() const
+	{
+		string result;
+
+		for(size_t phase=0; phase<numPhases; ++phase)
+			result += format("{:<8} {:>12.3f} ms\n",
+			                 phaseName(Phase(phase)),
+			                 chrono::duration<double, milli>(duration(Phase(phase))).count());
+
+		if(countersEnabled_)
+		{
+			const auto formatCounter = [](double value, fmt::string_view valueFormat)
+			{
+				return isnan(value) ? string("n/a") : vformat(valueFormat, make_format_args(value));
+			};
+
+			result += format("{:<8} {:>14} {:>14} {:>6} {:>14} {:>8} {:>14} {:>8}\n",
+			                 "", "cycles", "instructions", "IPC", "cache misses", "rate", "branch misses", "rate");
+
+			for(size_t phase=0; phase<numPhases; ++phase)
+			{
+				const CounterValues& phaseCounters = counters_[phase];
+
+				result += format("{:<8} {:>14} {:>14} {:>6} {:>14} {:>8} {:>14} {:>8}\n",
+				                 phaseName(Phase(phase)),
+				                 formatCounter(phaseCounters[static_cast<size_t>(CounterEvent::Cycles)], "{:.0f}"),
+				                 formatCounter(phaseCounters[static_cast<size_t>(CounterEvent::Instructions)], "{:.0f}"),
+				                 formatCounter(counterRatio(phaseCounters, CounterEvent::Instructions, CounterEvent::Cycles), "{:.2f}"),
+				                 formatCounter(phaseCounters[static_cast<size_t>(CounterEvent::CacheMisses)], "{:.0f}"),
+				                 formatCounter(100.0 * counterRatio(phaseCounters, CounterEvent::CacheMisses, CounterEvent::CacheReferences), "{:.2f}%"),
+				                 formatCounter(phaseCounters[static_cast<size_t>(CounterEvent::BranchMisses)], "{:.0f}"),
+				                 formatCounter(100.0 * counterRatio(phaseCounters, CounterEvent::BranchMisses, CounterEvent::Branches), "{:.2f}%"));
+			}
+
+			const string unavailabilityReason = performanceCountersUnavailabilityReason();
+
+			if(!unavailabilityReason.empty())
+				result += format("some performance counters are unavailable: {}\n", unavailabilityReason);
+		}
+
+		if(allocationsEnabled_)
+		{
+			result += format("{:<8} {:>14} {:>16} {:>16}\n", "", "allocations", "allocated bytes", "peak live bytes");
+
+			for(size_t phase=0; phase<numPhases; ++phase)
+			{
+				if(!allocationsTracked(Phase(phase)))
+				{
+					result += format("{:<8} {:>14} {:>16} {:>16}\n", phaseName(Phase(phase)), "n/a", "n/a", "n/a");
+					continue;
+				}
+
+				result += format("{:<8} {:>14} {:>16} {:>16}\n",
+				                 phaseName(Phase(phase)),
+				                 allocations_[phase].numAllocations_,
+				                 allocations_[phase].numAllocatedBytes_,
+				                 allocations_[phase].peakLiveBytes_);
+			}
+		}
+
+		if(answersInParsePhase_)
+			result += format("{}\n", answersInParsePhaseNote);
+
+		return result;
+	}
+
+	string PhaseTimings::toJson() const
+	{
+		const auto formatCounter = [](double value)
+		{
+			return isnan(value) ? string("null") : format("{:.6g}", value);
+		};
+
+		string result = "{";
+
+		for(size_t phase=0; phase<numPhases; ++phase)
+		{
+			result += format("{}\"{}_ns\":{}",
+			                 (phase > 0) ? "," : "",
+			                 phaseName(Phase(phase)),
+			                 chrono::duration_cast<chrono::nanoseconds>(duration(Phase(phase))).count());
+
+			if(allocationsEnabled_ && !allocationsTracked(Phase(phase)))
+				result += format(",\"{0}_allocations\":null,\"{0}_allocated_bytes\":null,\"{0}_peak_live_bytes\":null",
+				                 phaseName(Phase(phase)));
+			else if(allocationsEnabled_)
+				result += format(",\"{0}_allocations\":{1},\"{0}_allocated_bytes\":{2},\"{0}_peak_live_bytes\":{3}",
+				                 phaseName(Phase(phase)),
+				                 allocations_[phase].numAllocations_,
+				                 allocations_[phase].numAllocatedBytes_,
+				                 allocations_[phase].peakLiveBytes_);
+
+			if(!countersEnabled_)
+				continue;
+
+			const CounterValues& phaseCounters = counters_[phase];
+
+			for(size_t counterEvent=0; counterEvent<numCounterEvents; ++counterEvent)
+				result += format(",\"{}_{}\":{}",
+				                 phaseName(Phase(phase)),
+				                 counterEventName(CounterEvent(counterEvent)),
+				                 formatCounter(phaseCounters[counterEvent]));
+
+			result += format(",\"{0}_ipc\":{1},\"{0}_cache_miss_rate\":{2},\"{0}_branch_miss_rate\":{3}",
+			                 phaseName(Phase(phase)),
+			                 formatCounter(counterRatio(phaseCounters, CounterEvent::Instructions, CounterEvent::Cycles)),
+			                 formatCounter(counterRatio(phaseCounters, CounterEvent::CacheMisses, CounterEvent::CacheReferences)),
+			                 formatCounter(counterRatio(phaseCounters, CounterEvent::BranchMisses, CounterEvent::Branches)));
+		}
+
+		if(answersInParsePhase_)
+			result += ",\"answers_in_parse\":true";
+
+		return result + "}";
+	}
+
+	std::string_view complexityModelName(ComplexityModel complexityModel)
+	{
+		switch(complexityModel)
+		{
+			case ComplexityModel::Linear: return "n";
+			case ComplexityModel::Linearithmic: return "n log n";
+			case ComplexityModel::Quadratic: return "n^2";
+		}
+
+		panic(format("invalid complexity model: {}", static_cast<int>(complexityModel)));
+	}
+
+	ComplexityFit fitComplexity(const vector<double>& sizes,
+	                            const vector<double>& durations)
+	{
+		AOC_ASSERT(sizes.size() == durations.size());
+		AOC_ASSERT(sizes.size() >= 2);
+
+		ComplexityFit complexityFit;
+		double minResidual = numeric_limits<double>::infinity();
+
+		for(const ComplexityModel model : { ComplexityModel::Linear, ComplexityModel::Linearithmic, ComplexityModel::Quadratic })
+		{
+			const auto f = [&](double n)
+			{
+				switch(model)
+				{
+					case ComplexityModel::Linear: return n;
+					case ComplexityModel::Linearithmic: return n * log2(max(n, 2.0));
+					case ComplexityModel::Quadratic: return n * n;
+				}
+
+				return n;
+			};
+
+			// Least squares of the relative errors (1 - c * f(n) / t), which
+			// keeps the largest sizes from dominating the fit.
+			double sumRatios = 0.0;
+			double sumSquaredRatios = 0.0;
+
+			for(size_t i=0; i<sizes.size(); ++i)
+			{
+				const double ratio = f(sizes[i]) / durations[i];
+
+				sumRatios += ratio;
+				sumSquaredRatios += ratio * ratio;
+			}
+
+			const double c = sumRatios / sumSquaredRatios;
+			double residual = 0.0;
+
+			for(size_t i=0; i<sizes.size(); ++i)
+				residual += pow(1.0 - c * f(sizes[i]) / durations[i], 2.0);
+
+			if(residual < minResidual)
+			{
+				minResidual = residual;
+				complexityFit.model_ = model;
+			}
+		}
+
+		double meanLogSize = 0.0;
+		double meanLogDuration = 0.0;
+
+		for(size_t i=0; i<sizes.size(); ++i)
+		{
+			meanLogSize += log(sizes[i]) / sizes.size();
+			meanLogDuration += log(durations[i]) / sizes.size();
+		}
+
+		double covariance = 0.0;
+		double variance = 0.0;
+
+		for(size_t i=0; i<sizes.size(); ++i)
+		{
+			covariance += (log(sizes[i]) - meanLogSize) * (log(durations[i]) - meanLogDuration);
+			variance += pow(log(sizes[i]) - meanLogSize, 2.0);
+		}
+
+		AOC_ASSERT_MSG(variance > 0.0, "at least two distinct sizes expected");
+
+		complexityFit.exponent_ = covariance / variance;
+
+		return complexityFit;
+	}
+
+	SampleStatistics computeSampleStatistics(vector<double> samples)
+	{
+		SampleStatistics sampleStatistics;
+
+		if(samples.empty())
+			return sampleStatistics;
+
+		sort(samples.begin(), samples.end());
+
+		const size_t numSamples = samples.size();
+
+		sampleStatistics.min_ = samples.front();
+		sampleStatistics.median_ = (numSamples % 2 == 1) ? samples[numSamples / 2]
+		                                                  : (samples[numSamples / 2 - 1] + samples[numSamples / 2]) / 2.0;
+		sampleStatistics.p99_ = samples[(99 * numSamples + 99) / 100 - 1];
+
+		double sum = 0.0;
+
+		for(double sample : samples)
+			sum += sample;
+
+		sampleStatistics.mean_ = sum / numSamples;
+
+		if(numSamples > 1)
+		{
+			double sumOfSquaredDeviations = 0.0;
+
+			for(double sample : samples)
+				sumOfSquaredDeviations += (sample - sampleStatistics.mean_) * (sample - sampleStatistics.mean_);
+
+			sampleStatistics.standardDeviation_ = sqrt(sumOfSquaredDeviations / (numSamples - 1));
+		}
+
+		return sampleStatistics;
+	}
+
+	double mannWhitneyPValue(const vector<double>& baselineSamples,
+	                         const vector<double>& samples)
+	{
+		const size_t numBaselineSamples = baselineSamples.size();
+		const size_t numSamples = samples.size();
+
+		if((numBaselineSamples == 0) || (numSamples == 0))
+			return 1.0;
+
+		vector<pair<double, bool>> pooledSamples;
+
+		pooledSamples.reserve(numBaselineSamples + numSamples);
+
+		for(double sample : baselineSamples)
+			pooledSamples.emplace_back(sample, false);
+
+		for(double sample : samples)
+			pooledSamples.emplace_back(sample, true);
+
+		sort(pooledSamples.begin(), pooledSamples.end());
+
+		// Tied samples share the mean of their ranks; each group of t ties
+		// lowers the variance of U by t^3 - t.
+		double rankSum = 0.0;
+		double tieCorrection = 0.0;
+
+		for(size_t first=0; first<pooledSamples.size();)
+		{
+			size_t last = first + 1;
+
+			while((last < pooledSamples.size()) && (pooledSamples[last].first == pooledSamples[first].first))
+				++last;
+
+			const double rank = (first + 1 + last) / 2.0;
+			const double numTies = static_cast<double>(last - first);
+
+			for(size_t i=first; i<last; ++i)
+			{
+				if(pooledSamples[i].second)
+					rankSum += rank;
+			}
+
+			tieCorrection += numTies * numTies * numTies - numTies;
+			first = last;
+		}
+
+		const double n1 = static_cast<double>(numSamples);
+		const double n2 = static_cast<double>(numBaselineSamples);
+		const double n = n1 + n2;
+		const double u = rankSum - n1 * (n1 + 1.0) / 2.0;
+		const double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieCorrection / (n * (n - 1.0)));
+
+		if(variance <= 0.0)
+			return 1.0;
+
+		const double z = (u - n1 * n2 / 2.0 - 0.5) / sqrt(variance);
+
+		return 0.5 * erfc(z / sqrt(2.0));
+	}
+
+	void saveBenchmarkBaseline(const string& baselineFilePath,
+	                           const BenchmarkSamples& samples,
+	                           std::string_view comment)
+	{
+		ofstream fileStream{baselineFilePath, ios::binary | ios::trunc};
+
+		if(!fileStream)
+			panic(format("unable to write baseline file: \"{}\"", baselineFilePath));
+
+		fileStream << "# " << comment << '\n';
+
+		for(size_t phase=0; phase<numPhases; ++phase)
+		{
+			fileStream << phaseName(Phase(phase));
+
+			// Shortest representations read back exactly.
+			for(double sample : samples[phase])
+				fileStream << ' ' << format("{}", sample);
+
+			fileStream << '\n';
+		}
+
+		if(!fileStream.flush())
+			panic(format("unable to write baseline file: \"{}\"", baselineFilePath));
+	}
+
+	BenchmarkSamples loadBenchmarkBaseline(const string& baselineFilePath)
+	{
+		ifstream fileStream{baselineFilePath};
+
+		if(!fileStream)
+			panic(format("unable to open baseline file: \"{}\"", baselineFilePath));
+
+		BenchmarkSamples samples;
+		string line;
+
+		while(getline(fileStream, line))
+		{
+			if(line.empty() || line.starts_with('#'))
+				continue;
+
+			istringstream lineStream{line};
+			string name;
+
+			lineStream >> name;
+
+			size_t phase = 0;
+
+			while((phase < numPhases) && (phaseName(Phase(phase)) != name))
+				++phase;
+
+			if(phase == numPhases)
+				panic(format("unknown phase in baseline file \"{}\": '{}'", baselineFilePath, name));
+
+			samples[phase].clear();
+
+			for(string sample; lineStream >> sample;)
+			{
+				double value = 0.0;
+
+				const auto [end, error] = from_chars(sample.data(), sample.data() + sample.size(), value);
+
+				if((error != errc()) || (end != sample.data() + sample.size()))
+					panic(format("invalid sample in baseline file \"{}\": '{}'", baselineFilePath, sample));
+
+				samples[phase].push_back(value);
+			}
+		}
+
+		return samples;
+	}
+
+	array<PhaseComparison, numPhases> compareWithBaseline(const BenchmarkSamples& baselineSamples,
+	                                                      const BenchmarkSamples& samples,
+	                                                      double regressionThreshold)
+	{
+		array<PhaseComparison, numPhases> phaseComparisons;
+
+		for(size_t phase=0; phase<numPhases; ++phase)
+		{
+			PhaseComparison& phaseComparison = phaseComparisons[phase];
+
+			phaseComparison.baselineMedian_ = computeSampleStatistics(baselineSamples[phase]).median_;
+			phaseComparison.median_ = computeSampleStatistics(samples[phase]).median_;
+			phaseComparison.pValue_ = mannWhitneyPValue(baselineSamples[phase], samples[phase]);
+			phaseComparison.regression_ = (phaseComparison.pValue_ < PhaseComparison::significanceLevel) &&
+			                              (phaseComparison.median_ > phaseComparison.baselineMedian_ * (1.0 + regressionThreshold)) &&
+			                              (phaseComparison.median_ - phaseComparison.baselineMedian_ > PhaseComparison::minDifferenceMs);
+		}
+
+		return phaseComparisons;
+	}
+
+	static size_t parseCount(std::string_view option,
+	                         std::string_view count)
+	{
+		size_t result = 0;
+
+		const auto [end, error] = from_chars(count.data(), count.data() + count.size(), result);
+
+		if((error != errc()) || (end != count.data() + count.size()))
+			panic(format("invalid value of option '{}': '{}'", option, count));
+
+		return result;
+	}
+
+	static double parseParameterValue(std::string_view name,
+	                                  std::string_view value)
+	{
+		double result = 0.0;
+
+		const auto [end, error] = from_chars(value.data(), value.data() + value.size(), result);
+
+		if((error != errc()) || (end != value.data() + value.size()))
+			panic(format("invalid value of parameter '{}': '{}'", name, value));
+
+		return result;
+	}
+
+	static TimingsReport parseTimingsReport(std::string_view timingsReport)
+	{
+		if((timingsReport == "text") || (timingsReport == "1"))
+			return TimingsReport::Text;
+
+		if(timingsReport == "json")
+			return TimingsReport::Json;
+
+		panic(format("invalid timings report: '{}'", timingsReport));
+	}
+
+	RunOptions parseRunOptions(int argc,
+	                           char* argv[],
+	                           const string& defaultPuzzleInputFilePath)
+	{
+		RunOptions runOptions;
+
+		runOptions.puzzleInputFilePath_ = defaultPuzzleInputFilePath;
+
+		if(const char* timingsReport = getenv("AOC_TIMINGS"))
+			runOptions.timingsReport_ = parseTimingsReport(timingsReport);
+
+		if(const char* performanceCounters = getenv("AOC_COUNTERS"))
+			runOptions.performanceCounters_ = std::string_view(performanceCounters) == "1";
+
+		vector<string> puzzleInputFilePaths;
+
+		for(int i=1; i<argc; ++i)
+		{
+			const std::string_view argument = argv[i];
+
+			if(argument == "--timings")
+			{
+				runOptions.timingsReport_ = TimingsReport::Text;
+			}
+			else if(argument.starts_with("--timings="))
+			{
+				runOptions.timingsReport_ = parseTimingsReport(argument.substr(argument.find('=') + 1));
+			}
+			else if(argument == "--counters")
+			{
+				runOptions.performanceCounters_ = true;
+			}
+			else if(argument == "--benchmark")
+			{
+				runOptions.numBenchmarkIterations_ = 100;
+			}
+			else if(argument.starts_with("--benchmark="))
+			{
+				runOptions.numBenchmarkIterations_ = parseCount("--benchmark", argument.substr(argument.find('=') + 1));
+
+				if(runOptions.numBenchmarkIterations_ == 0)
+					panic("at least one benchmark iteration expected");
+			}
+			else if(argument.starts_with("--warmup="))
+			{
+				runOptions.numWarmupIterations_ = parseCount("--warmup", argument.substr(argument.find('=') + 1));
+			}
+			else if(argument == "--batch")
+			{
+				runOptions.batch_ = true;
+			}
+			else if(argument.starts_with("--generate="))
+			{
+				runOptions.generate_ = true;
+				runOptions.inputGeneration_.size_ = parseCount("--generate", argument.substr(argument.find('=') + 1));
+			}
+			else if(argument.starts_with("--seed="))
+			{
+				runOptions.inputGeneration_.seed_ = parseCount("--seed", argument.substr(argument.find('=') + 1));
+			}
+			else if(argument.starts_with("--parameter="))
+			{
+				const std::string_view parameter = argument.substr(argument.find('=') + 1);
+				const size_t separatorPos = parameter.find('=');
+
+				if((separatorPos == std::string_view::npos) || (separatorPos == 0))
+					panic(format("invalid parameter: '{}'", parameter));
+
+				runOptions.inputGeneration_.parameters_.emplace_back(parameter.substr(0, separatorPos),
+				                                                     parseParameterValue(parameter.substr(0, separatorPos),
+				                                                                         parameter.substr(separatorPos + 1)));
+			}
+			else if(argument.starts_with("--save-baseline="))
+			{
+				runOptions.saveBaselineFilePath_ = argument.substr(argument.find('=') + 1);
+			}
+			else if(argument.starts_with("--compare-baseline="))
+			{
+				runOptions.compareBaselineFilePath_ = argument.substr(argument.find('=') + 1);
+			}
+			else if(argument.starts_with("--regression-threshold="))
+			{
+				const std::string_view threshold = argument.substr(argument.find('=') + 1);
+				const auto [end, error] = from_chars(threshold.data(), threshold.data() + threshold.size(), runOptions.regressionThreshold_);
+
+				if((error != errc()) || (end != threshold.data() + threshold.size()) || (runOptions.regressionThreshold_ < 0.0))
+					panic(format("invalid value of option '--regression-threshold': '{}'", threshold));
+			}
+			else if(argument.starts_with("--scaling="))
+			{
+				const std::string_view sizes = argument.substr(argument.find('=') + 1);
+				const size_t separatorPos = sizes.find(':');
+
+				if(separatorPos == std::string_view::npos)
+					panic(format("invalid value of option '--scaling': '{}'", sizes));
+
+				runOptions.minScalingSize_ = parseCount("--scaling", sizes.substr(0, separatorPos));
+				runOptions.maxScalingSize_ = parseCount("--scaling", sizes.substr(separatorPos + 1));
+
+				if((runOptions.minScalingSize_ == 0) || (runOptions.maxScalingSize_ < 2 * runOptions.minScalingSize_))
+					panic("--scaling needs a positive minimum size and a maximum size of at least twice the minimum");
+			}
+			else if(argument.starts_with("--trace="))
+			{
+				runOptions.traceFilePath_ = argument.substr(argument.find('=') + 1);
+			}
+			else if(argument.starts_with("--threads="))
+			{
+				runOptions.numThreads_ = static_cast<unsigned>(parseCount("--threads", argument.substr(argument.find('=') + 1)));
+
+				if(runOptions.numThreads_ == 0)
+					panic("at least one thread expected");
+			}
+			else if(argument.starts_with("--"))
+			{
+				panic(format("unknown option: '{}'", argument));
+			}
+			else
+			{
+				puzzleInputFilePaths.emplace_back(argument);
+			}
+		}
+
+		if((!runOptions.saveBaselineFilePath_.empty() || !runOptions.compareBaselineFilePath_.empty()) &&
+		   (runOptions.numBenchmarkIterations_ == 0))
+			runOptions.numBenchmarkIterations_ = 100;
+
+		if(runOptions.generate_)
+		{
+			if(runOptions.batch_ || (runOptions.numBenchmarkIterations_ > 0))
+				panic("--generate cannot be combined with --batch or --benchmark");
+
+			if(puzzleInputFilePaths.size() > 1)
+				panic(format("unexpected argument: '{}'", puzzleInputFilePaths[1]));
+
+			if(!puzzleInputFilePaths.empty())
+				runOptions.generatedInputFilePath_ = puzzleInputFilePaths[0];
+		}
+		else if(runOptions.batch_)
+		{
+			if(runOptions.numBenchmarkIterations_ > 0)
+				panic("batch mode cannot be combined with --benchmark");
+
+			runOptions.batchInputPaths_ = puzzleInputFilePaths.empty() ? vector<string>{defaultPuzzleInputFilePath}
+			                                                           : std::move(puzzleInputFilePaths);
+		}
+		else if(!puzzleInputFilePaths.empty())
+		{
+			if(puzzleInputFilePaths.size() > 1)
+				panic(format("unexpected argument: '{}'", puzzleInputFilePaths[1]));
+
+			runOptions.puzzleInputFilePath_ = puzzleInputFilePaths[0];
+		}
+
+		if(runOptions.performanceCounters_ && (runOptions.timingsReport_ == TimingsReport::None))
+			runOptions.timingsReport_ = TimingsReport::Text;
+
+		return runOptions;
+	}
+
+	int PuzzleSolution::run(const string& puzzleInputFilePath)
+	{
+		RunOptions runOptions;
+
+		runOptions.puzzleInputFilePath_ = puzzleInputFilePath;
+
+		return run(runOptions);
+	}
+
+	int PuzzleSolution::run(const RunOptions& runOptions)
+	{
+		if(runOptions.traceFilePath_.empty())
+			return dispatch(runOptions);
+
+		startTracing(runOptions.traceFilePath_);
+
+		const int exitCode = dispatch(runOptions);
+
+		stopTracing();
+
+		return exitCode;
+	}
+
+	int PuzzleSolution::dispatch(const RunOptions& runOptions)
+	{
+		if(runOptions.numThreads_ > 0)
+			setNumWorkerThreads(runOptions.numThreads_);
+
+		if(runOptions.generate_)
+		{
+			runGenerator(runOptions);
+
+			return EXIT_SUCCESS;
+		}
+
+		if(runOptions.maxScalingSize_ > 0)
+			return runScaling(runOptions);
+
+		if(runOptions.batch_)
+			return runBatch(runOptions);
+
+		if(runOptions.numBenchmarkIterations_ > 0)
+			return runBenchmark(runOptions);
+
+		phaseTimings_.reset();
+		phaseTimings_.setEnabled(runOptions.timingsReport_ != TimingsReport::None);
+		phaseTimings_.setCountersEnabled(runOptions.performanceCounters_);
+		phaseTimings_.setAllocationsEnabled(allocationTrackingEnabled());
+
+		const array<int, 2> answers = solve(runOptions.puzzleInputFilePath_);
+
+		println("{}", answers[0]);
+		println("{}", answers[1]);
+
+		switch(runOptions.timingsReport_)
+		{
+			case TimingsReport::None:
+				break;
+
+			case TimingsReport::Text:
+				print(stderr, "{}", phaseTimings_.toString());
+				break;
+
+			case TimingsReport::Json:
+				println(stderr, "{}", phaseTimings_.toJson());
+				break;
+		}
+
+		return EXIT_SUCCESS;
+	}
+
+	int PuzzleSolution::run(int argc,
+	                        char* argv[],
+	                        const string& defaultPuzzleInputFilePath)
+	{
+		return run(parseRunOptions(argc, argv, defaultPuzzleInputFilePath));
+	}
+
+	array<int, 2> PuzzleSolution::solve(const string& puzzleInputFilePath)
+	{
+		return solveInput([&] { processInput(puzzleInputFilePath); });
+	}
+
+	array<int, 2> PuzzleSolution::solveText(string text)
+	{
+		return solveInput([&] { processText(std::move(text)); });
+	}
+
+	array<int, 2> PuzzleSolution::solveInput(const function<void()>& processPuzzleInput)
+	{
+		phaseTimings_.setAnswersInParsePhase(answersComputedWhileParsing());
+		phaseTimings_.setConcurrentAnswers(answerEvaluation_ == AnswerEvaluation::Concurrent);
+
+		ScopedPhaseTimer totalTimer{phaseTimings_, Phase::Total};
+
+		{
+			ScopedPhaseTimer parseTimer{phaseTimings_, Phase::Parse};
+
+			processPuzzleInput();
+		}
+
+		// Loading is timed inside processInput(), which the parse phase
+		// covers as a whole.
+		phaseTimings_.excludeNestedPhase(Phase::Parse, Phase::Load);
+
+		array<int, 2> answers;
+
+		switch(answerEvaluation_)
+		{
+			case AnswerEvaluation::Sequential:
+			{
+				answers[0] = evaluateAnswer(0);
+				answers[1] = evaluateAnswer(1);
+
+				break;
+			}
+
+			case AnswerEvaluation::Concurrent:
+			{
+				parallelFor(2, [&](size_t answerIndex)
+				{
+					answers[answerIndex] = evaluateAnswer(answerIndex);
+				});
+
+				break;
+			}
+		}
+
+		return answers;
+	}
+
+	int PuzzleSolution::evaluateAnswer(size_t answerIndex)
+	{
+		if(answerIndex == 0)
+		{
+			ScopedPhaseTimer answerTimer{phaseTimings_, Phase::Answer1};
+
+			return answer1();
+		}
+		else
+		{
+			ScopedPhaseTimer answerTimer{phaseTimings_, Phase::Answer2};
+
+			return answer2();
+		}
+	}
+
+	void PuzzleSolution::generateInput(ostream& /*stream*/,
+	                                   const InputGeneration& /*inputGeneration*/) const
+	{
+		panic("this puzzle solution has no input generator");
+	}
+
+	void PuzzleSolution::runGenerator(const RunOptions& runOptions) const
+	{
+		if(runOptions.generatedInputFilePath_.empty())
+		{
+#if defined(_WIN32)
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+			generateInput(cout, runOptions.inputGeneration_);
+			cout.flush();
+
+			if(!cout)
+				panic("unable to write generated input to the standard output");
+		}
+		else
+		{
+			ofstream fileStream{runOptions.generatedInputFilePath_, ios::binary | ios::trunc};
+
+			if(!fileStream.is_open())
+				panic(format("unable to create output file: \"{}\"", runOptions.generatedInputFilePath_));
+
+			generateInput(fileStream, runOptions.inputGeneration_);
+			fileStream.close();
+
+			if(!fileStream)
+				panic(format("unable to write output file: \"{}\"", runOptions.generatedInputFilePath_));
+		}
+	}
+
+	int PuzzleSolution::runScaling(const RunOptions& runOptions)
+	{
+		constexpr size_t numIterations = 3;
+
+		// Phases which stay faster than this at the largest size are mostly
+		// noise and are not fitted.
+		constexpr double minFittedDurationMs = 0.1;
+
+		const string filePath = (filesystem::temp_directory_path() / format("aoc-scaling-{}.txt", getpid())).string();
+
+		vector<double> numBytes;
+		array<vector<double>, numPhases> durations;
+
+		phaseTimings_.setCountersEnabled(false);
+		phaseTimings_.setAllocationsEnabled(false);
+
+		println("{:>12} {:>14} {:>12} {:>12} {:>12} {:>12} {:>12}",
+		        "size", "bytes", "load [ms]", "parse [ms]", "answer1 [ms]", "answer2 [ms]", "total [ms]");
+
+		for(size_t size=runOptions.minScalingSize_; size<=runOptions.maxScalingSize_; size*=2)
+		{
+			InputGeneration inputGeneration = runOptions.inputGeneration_;
+
+			inputGeneration.size_ = size;
+
+			{
+				ofstream fileStream{filePath, ios::binary | ios::trunc};
+
+				if(!fileStream.is_open())
+					panic(format("unable to create output file: \"{}\"", filePath));
+
+				generateInput(fileStream, inputGeneration);
+			}
+
+			phaseTimings_.setEnabled(false);
+			doNotOptimize(solve(filePath));
+			phaseTimings_.setEnabled(true);
+
+			array<double, numPhases> minDurations;
+
+			minDurations.fill(numeric_limits<double>::infinity());
+
+			for(size_t iteration=0; iteration<numIterations; ++iteration)
+			{
+				phaseTimings_.reset();
+				doNotOptimize(solve(filePath));
+
+				for(size_t phase=0; phase<numPhases; ++phase)
+					minDurations[phase] = min(minDurations[phase], chrono::duration<double, milli>(phaseTimings_.duration(Phase(phase))).count());
+			}
+
+			numBytes.push_back(static_cast<double>(filesystem::file_size(filePath)));
+
+			for(size_t phase=0; phase<numPhases; ++phase)
+				durations[phase].push_back(minDurations[phase]);
+
+			println("{:>12} {:>14} {:>12.4f} {:>12.4f} {:>12.4f} {:>12.4f} {:>12.4f}",
+			        size, numBytes.back(), minDurations[0], minDurations[1], minDurations[2], minDurations[3], minDurations[4]);
+		}
+
+		filesystem::remove(filePath);
+
+		println("{:<8} {:>10} {:>10}", "phase", "best fit", "exponent");
+
+		bool superLinear = false;
+
+		for(size_t phase=0; phase<numPhases; ++phase)
+		{
+			if(durations[phase].back() < minFittedDurationMs)
+			{
+				println("{:<8} {:>10} {:>10}", phaseName(Phase(phase)), "-", "-");
+				continue;
+			}
+
+			// Clamped away from zero, as the logarithm of the fit needs
+			// positive durations.
+			vector<double> phaseDurations = durations[phase];
+
+			for(double& duration : phaseDurations)
+				duration = max(duration, 1e-6);
+
+			const ComplexityFit complexityFit = fitComplexity(numBytes, phaseDurations);
+
+			println("{:<8} {:>10} {:>10.2f}{}",
+			        phaseName(Phase(phase)),
+			        complexityModelName(complexityFit.model_),
+			        complexityFit.exponent_,
+			        complexityFit.superLinear() ? "  super-linear" : "");
+
+			superLinear = superLinear || complexityFit.superLinear();
+		}
+
+		if(answersComputedWhileParsing())
+			println("{}", answersInParsePhaseNote);
+
+		return superLinear ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	static string escapeJsonString(std::string_view text)
+	{
+		string result;
+
+		for(const char character : text)
+		{
+			if((character == '"') || (character == '\\'))
+				result += format("\\{}", character);
+			else if(static_cast<unsigned char>(character) < 0x20)
+				result += format("\\u{:04x}", static_cast<unsigned char>(character));
+			else
+				result += character;
+		}
+
+		return result;
+	}
+
+	class TraceEvent
+	{
+	public:
+		const char* name_;
+		int64_t index_;
+		chrono::steady_clock::duration start_;
+		chrono::steady_clock::duration duration_;
+	};
+
+	// Events of a single thread, appended by that thread only. Chunks are
+	// allocated as needed and published, together with the events in them,
+	// by the release store of the event count, so that a reader needs no
+	// lock either.
+	class TraceBuffer
+	{
+	public:
+		explicit TraceBuffer(size_t threadIndex) : threadIndex_(threadIndex) {}
+
+	public:
+		void append(const TraceEvent& event);
+		void writeEvents(ostream& stream,
+		                 int processId,
+		                 bool& firstEvent) const;
+
+	public:
+		const size_t threadIndex_;
+		TraceBuffer* next_ = nullptr;
+
+	private:
+		static constexpr size_t chunkSize = 4096;
+		static constexpr size_t maxNumChunks = 1024;
+
+	private:
+		array<unique_ptr<array<TraceEvent, chunkSize>>, maxNumChunks> chunks_;
+		atomic<size_t> numEvents_{0};
+		atomic<size_t> numDroppedEvents_{0};
+	};
+
+	void TraceBuffer::append(const TraceEvent& event)
+	{
+		const size_t numEvents = numEvents_.load(memory_order_relaxed);
+
+		if(numEvents == chunkSize * maxNumChunks)
+		{
+			numDroppedEvents_.fetch_add(1, memory_order_relaxed);
+
+			return;
+		}
+
+		if(numEvents % chunkSize == 0)
+			chunks_[numEvents / chunkSize] = make_unique<array<TraceEvent, chunkSize>>();
+
+		(*chunks_[numEvents / chunkSize])[numEvents % chunkSize] = event;
+
+		numEvents_.store(numEvents + 1, memory_order_release);
+	}
+
+	void TraceBuffer::writeEvents(ostream& stream,
+	                              int processId,
+	                              bool& firstEvent) const
+	{
+		const auto separator = [&]
+		{
+			const char* result = firstEvent ? "\n" : ",\n";
+
+			firstEvent = false;
+
+			return result;
+		};
+
+		stream << separator()
+		       << format(R"({{"name":"thread_name","ph":"M","pid":{},"tid":{},"args":{{"name":"thread {}"}}}})",
+		                 processId, threadIndex_, threadIndex_);
+
+		const size_t numEvents = numEvents_.load(memory_order_acquire);
+
+		for(size_t eventIndex=0; eventIndex<numEvents; ++eventIndex)
+		{
+			const TraceEvent& event = (*chunks_[eventIndex / chunkSize])[eventIndex % chunkSize];
+
+			stream << separator()
+			       << format(R"({{"name":"{}","ph":"X","pid":{},"tid":{},"ts":{:.3f},"dur":{:.3f})",
+			                 escapeJsonString(event.name_),
+			                 processId,
+			                 threadIndex_,
+			                 chrono::duration<double, micro>(event.start_).count(),
+			                 chrono::duration<double, micro>(event.duration_).count());
+
+			if(event.index_ >= 0)
+				stream << format(R"(,"args":{{"index":{}}})", event.index_);
+
+			stream << '}';
+		}
+
+		if(const size_t numDroppedEvents = numDroppedEvents_.load(memory_order_relaxed); numDroppedEvents > 0)
+			println(stderr, "thread {} dropped {} trace events", threadIndex_, numDroppedEvents);
+	}
+
+	// Buffers of the current tracing session, pushed onto a lock-free list
+	// by the threads recording their first span in it.
+	static atomic<bool> tracingEnabled_{false};
+	static atomic<uint64_t> tracingSession_{0};
+	static atomic<TraceBuffer*> traceBuffers_{nullptr};
+	static atomic<size_t> numTraceBuffers_{0};
+	static chrono::steady_clock::time_point tracingStartTime_;
+	static string traceFilePath_;
+
+	bool tracingEnabled()
+	{
+		return tracingEnabled_.load(memory_order_relaxed);
+	}
+
+	void startTracing(const string& traceFilePath)
+	{
+		if(tracingEnabled_)
+			panic("tracing has already been started");
+
+		traceFilePath_ = traceFilePath;
+		tracingStartTime_ = chrono::steady_clock::now();
+		tracingSession_.fetch_add(1, memory_order_relaxed);
+		tracingEnabled_.store(true, memory_order_release);
+	}
+
+	static TraceBuffer& threadTraceBuffer()
+	{
+		thread_local TraceBuffer* traceBuffer = nullptr;
+		thread_local uint64_t traceBufferSession = 0;
+
+		// The buffer of a previous session has been freed by stopTracing().
+		const uint64_t session = tracingSession_.load(memory_order_relaxed);
+
+		if(!traceBuffer || (traceBufferSession != session))
+		{
+			traceBuffer = new TraceBuffer{numTraceBuffers_.fetch_add(1, memory_order_relaxed)};
+			traceBufferSession = session;
+			traceBuffer->next_ = traceBuffers_.load(memory_order_relaxed);
+
+			while(!traceBuffers_.compare_exchange_weak(traceBuffer->next_, traceBuffer, memory_order_release, memory_order_relaxed))
+			{
+			}
+		}
+
+		return *traceBuffer;
+	}
+
+	void recordTraceSpan(const char* name,
+	                     int64_t index,
+	                     chrono::steady_clock::time_point startTime,
+	                     chrono::steady_clock::time_point endTime)
+	{
+		// A span which outlived the trace is dropped.
+		if(!tracingEnabled_.load(memory_order_acquire))
+			return;
+
+		threadTraceBuffer().append({ name, index, startTime - tracingStartTime_, endTime - startTime });
+	}
+
+	void stopTracing()
+	{
+		if(!tracingEnabled_.exchange(false))
+			panic("tracing has not been started");
+
+		TraceBuffer* traceBuffers = traceBuffers_.exchange(nullptr, memory_order_acquire);
+		vector<unique_ptr<TraceBuffer>> buffers;
+
+		for(TraceBuffer* traceBuffer=traceBuffers; traceBuffer; traceBuffer=traceBuffer->next_)
+			buffers.emplace_back(traceBuffer);
+
+		numTraceBuffers_ = 0;
+
+		// In the order threads started recording.
+		reverse(buffers.begin(), buffers.end());
+
+		ofstream fileStream{traceFilePath_, ios::binary | ios::trunc};
+
+		if(!fileStream)
+			panic(format("unable to write trace file: \"{}\"", traceFilePath_));
+
+		bool firstEvent = true;
+
+		fileStream << R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+		for(const unique_ptr<TraceBuffer>& buffer : buffers)
+			buffer->writeEvents(fileStream, static_cast<int>(getpid()), firstEvent);
+
+		fileStream << "\n]}\n";
+
+		if(!fileStream.flush())
+			panic(format("unable to write trace file: \"{}\"", traceFilePath_));
+	}
+
+	int PuzzleSolution::runBatch(const RunOptions& runOptions)
+	{
+		const RegisteredPuzzleSolution* puzzleSolution = findRegisteredPuzzleSolution(typeid(*this));
+
+		if(!puzzleSolution)
+			panic("batch mode requires a solution registered with AOC_REGISTER_PUZZLE_SOLUTION");
+
+		const vector<string> puzzleInputFilePaths = expandBatchInputPaths(runOptions.batchInputPaths_);
+		const vector<PuzzleRunResult> results = solvePuzzleBatch(*puzzleSolution, puzzleInputFilePaths, numWorkerThreads());
+		bool failed = false;
+
+		for(size_t index=0; index<results.size(); ++index)
+		{
+			const PuzzleRunResult& result = results[index];
+
+			if(!result.error_.empty())
+			{
+				failed = true;
+
+				if(runOptions.timingsReport_ == TimingsReport::Json)
+					println(R"({{"input":"{}","error":"{}"}})", escapeJsonString(puzzleInputFilePaths[index]), escapeJsonString(result.error_));
+				else
+					println("{} error {}", puzzleInputFilePaths[index], result.error_);
+
+				continue;
+			}
+
+			switch(runOptions.timingsReport_)
+			{
+				case TimingsReport::None:
+					println("{} {} {}", puzzleInputFilePaths[index], result.answers_[0], result.answers_[1]);
+					break;
+
+				case TimingsReport::Text:
+					println("{} {} {} {:.3f} ms",
+					        puzzleInputFilePaths[index],
+					        result.answers_[0],
+					        result.answers_[1],
+					        chrono::duration<double, milli>(result.duration_).count());
+					break;
+
+				case TimingsReport::Json:
+					println(R"({{"input":"{}","answer1":{},"answer2":{},"total_ns":{}}})",
+					        escapeJsonString(puzzleInputFilePaths[index]),
+					        result.answers_[0],
+					        result.answers_[1],
+					        chrono::duration_cast<chrono::nanoseconds>(result.duration_).count());
+					break;
+			}
+		}
+
+		return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	int PuzzleSolution::runBenchmark(const RunOptions& runOptions)
+	{
+		phaseTimings_.setEnabled(false);
+		phaseTimings_.setCountersEnabled(false);
+		phaseTimings_.setAllocationsEnabled(false);
+
+		for(size_t iteration=0; iteration<runOptions.numWarmupIterations_; ++iteration)
+			doNotOptimize(solve(runOptions.puzzleInputFilePath_));
+
+		phaseTimings_.setEnabled(true);
+
+		BenchmarkSamples samples;
+		array<int, 2> answers = {};
+
+		for(size_t iteration=0; iteration<runOptions.numBenchmarkIterations_; ++iteration)
+		{
+			phaseTimings_.reset();
+
+			answers = solve(runOptions.puzzleInputFilePath_);
+
+			doNotOptimize(answers);
+
+			for(size_t phase=0; phase<numPhases; ++phase)
+				samples[phase].push_back(chrono::duration<double, milli>(phaseTimings_.duration(Phase(phase))).count());
+		}
+
+		println("{}", answers[0]);
+		println("{}", answers[1]);
+
+		println("{:<8} {:>12} {:>12} {:>12} {:>12} {:>12}  ({} iterations, {} warm-up)",
+		        "[ms]", "min", "median", "mean", "p99", "stddev",
+		        runOptions.numBenchmarkIterations_, runOptions.numWarmupIterations_);
+
+		for(size_t phase=0; phase<numPhases; ++phase)
+		{
+			const SampleStatistics sampleStatistics = computeSampleStatistics(samples[phase]);
+
+			println("{:<8} {:>12.4f} {:>12.4f} {:>12.4f} {:>12.4f} {:>12.4f}",
+			        phaseName(Phase(phase)),
+			        sampleStatistics.min_,
+			        sampleStatistics.median_,
+			        sampleStatistics.mean_,
+			        sampleStatistics.p99_,
+			        sampleStatistics.standardDeviation_);
+		}
+
+		if(answersComputedWhileParsing())
+			println("{}", answersInParsePhaseNote);
+
+		if(!runOptions.saveBaselineFilePath_.empty())
+			saveBenchmarkBaseline(runOptions.saveBaselineFilePath_,
+			                      samples,
+			                      format("{} ({} iterations, {} warm-up)",
+			                             runOptions.puzzleInputFilePath_,
+			                             runOptions.numBenchmarkIterations_,
+			                             runOptions.numWarmupIterations_));
+
+		if(runOptions.compareBaselineFilePath_.empty())
+			return EXIT_SUCCESS;
+
+		const array<PhaseComparison, numPhases> phaseComparisons = compareWithBaseline(loadBenchmarkBaseline(runOptions.compareBaselineFilePath_),
+		                                                                               samples,
+		                                                                               runOptions.regressionThreshold_);
+		bool regressed = false;
+
+		println("{:<8} {:>12} {:>12} {:>9} {:>10}  (threshold {:+.1f}%)",
+		        "[ms]", "baseline", "median", "change", "p-value",
+		        100.0 * runOptions.regressionThreshold_);
+
+		for(size_t phase=0; phase<numPhases; ++phase)
+		{
+			const PhaseComparison& phaseComparison = phaseComparisons[phase];
+			const double change = (phaseComparison.baselineMedian_ > 0.0) ? phaseComparison.median_ / phaseComparison.baselineMedian_ - 1.0
+			                                                              : 0.0;
+
+			println("{:<8} {:>12.4f} {:>12.4f} {:>+8.1f}% {:>10.2g}{}",
+			        phaseName(Phase(phase)),
+			        phaseComparison.baselineMedian_,
+			        phaseComparison.median_,
+			        100.0 * change,
+			        phaseComparison.pValue_,
+			        phaseComparison.regression_ ? "  REGRESSION" : "");
+
+			regressed = regressed || phaseComparison.regression_;
+		}
+
+		return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	void PuzzleSolution::processInput(const string& puzzleInputFilePath)
+	{
+		ScopedPhaseTimer loadTimer{phaseTimings_, Phase::Load};
+
+		switch(inputLoading_)
+		{
+			case InputLoading::Buffered:
+				input_ = loadBufferedPuzzleInput(puzzleInputFilePath, input_.releaseBuffer());
+				break;
+
+			case InputLoading::MemoryMapped:
+				input_ = loadMappedPuzzleInput(puzzleInputFilePath);
+				break;
+		}
+	}
+
+	void PuzzleSolution::processText(string text)
+	{
+		ScopedPhaseTimer loadTimer{phaseTimings_, Phase::Load};
+
+		input_ = LineArena(std::move(text));
+	}
+
+	void StreamingPuzzleSolution::processInput(const string& puzzleInputFilePath)
+	{
+		ChunkReader chunkReader{puzzleInputFilePath, chunkSize_};
+
+		partialLine_.clear();
+
+		startInput();
+
+		// Only the time spent waiting for the reader counts as loading.
+		const auto nextChunk = [&]
+		{
+			ScopedPhaseTimer loadTimer{phaseTimings(), Phase::Load};
+
+			return chunkReader.nextChunk();
+		};
+
+		for(std::string_view chunk = nextChunk(); !chunk.empty(); chunk = nextChunk())
+			processChunk(chunk);
+
+		finishInput();
+	}
+
+	void StreamingPuzzleSolution::processText(string text)
+	{
+		partialLine_.clear();
+
+		startInput();
+
+		for(std::string_view remainder = text; !remainder.empty(); remainder.remove_prefix(min(chunkSize_, remainder.size())))
+			processChunk(remainder.substr(0, chunkSize_));
+
+		finishInput();
+	}
+
+	void StreamingPuzzleSolution::processChunk(std::string_view chunk)
+	{
+		size_t lineStartPos = 0;
+		size_t lineEndPos = chunk.find('\n');
+
+		while(lineEndPos != std::string_view::npos)
+		{
+			const std::string_view line = chunk.substr(lineStartPos, lineEndPos - lineStartPos);
+
+			if(partialLine_.empty())
+			{
+				processLine(line);
+			}
+			else
+			{
+				partialLine_ += line;
+				processLine(partialLine_);
+				partialLine_.clear();
+			}
+
+			lineStartPos = lineEndPos + 1;
+			lineEndPos = chunk.find('\n', lineStartPos);
+		}
+
+		partialLine_ += chunk.substr(lineStartPos);
+	}
+
+	void StreamingPuzzleSolution::finishInput()
+	{
+		if(!partialLine_.empty())
+		{
+			processLine(partialLine_);
+			partialLine_.clear();
+		}
+	}
+
+	static vector<RegisteredPuzzleSolution>& puzzleSolutionRegistry()
+	{
+		// Constructed on first use, as registrations run during the static
+		// initialisation of other translation units.
+		static vector<RegisteredPuzzleSolution> registry;
+
+		return registry;
+	}
+
+	PuzzleSolutionRegistration::PuzzleSolutionRegistration(std::string_view puzzleId,
+	                                                       const type_info& typeInfo,
+	                                                       PuzzleSolutionFactory createPuzzleSolution)
+	{
+		vector<RegisteredPuzzleSolution>& registry = puzzleSolutionRegistry();
+
+		const auto position = lower_bound(registry.begin(), registry.end(), puzzleId,
+		                                  [](const RegisteredPuzzleSolution& puzzleSolution, std::string_view puzzleId)
+		                                  {
+		                                      return puzzleSolution.puzzleId_ < puzzleId;
+		                                  });
+
+		AOC_ASSERT_MSG((position == registry.end()) || (position->puzzleId_ != puzzleId),
+		               format("puzzle solution registered more than once: '{}'", puzzleId));
+
+		registry.insert(position, { puzzleId, &typeInfo, createPuzzleSolution });
+	}
+
+	const vector<RegisteredPuzzleSolution>& registeredPuzzleSolutions()
+	{
+		return puzzleSolutionRegistry();
+	}
+
+	const RegisteredPuzzleSolution* findRegisteredPuzzleSolution(std::string_view puzzleId)
+	{
+		const vector<RegisteredPuzzleSolution>& registry = puzzleSolutionRegistry();
+
+		const auto position = find_if(registry.begin(), registry.end(),
+		                              [&](const RegisteredPuzzleSolution& puzzleSolution)
+		                              {
+		                                  return puzzleSolution.puzzleId_ == puzzleId;
+		                              });
+
+		return (position != registry.end()) ? &*position : nullptr;
+	}
+
+	const RegisteredPuzzleSolution* findRegisteredPuzzleSolution(const type_info& typeInfo)
+	{
+		const vector<RegisteredPuzzleSolution>& registry = puzzleSolutionRegistry();
+
+		const auto position = find_if(registry.begin(), registry.end(),
+		                              [&](const RegisteredPuzzleSolution& puzzleSolution)
+		                              {
+		                                  return *puzzleSolution.typeInfo_ == typeInfo;
+		                              });
+
+		return (position != registry.end()) ? &*position : nullptr;
+	}
+
+	vector<PuzzleRunResult> solvePuzzles(const vector<PuzzleRun>& puzzleRuns,
+	                                     unsigned numThreads)
+	{
+		AOC_ASSERT(numThreads > 0);
+
+		vector<PuzzleRunResult> results(puzzleRuns.size());
+		atomic<size_t> nextPuzzleRunIndex{0};
+
+		// A puzzle which fails does so on its own instead of ending the run.
+		const bool panicThrows = panicThrows_.exchange(true);
+
+		try
+		{
+			parallelFor(min<size_t>(numThreads, puzzleRuns.size()), [&](size_t)
+			{
+				for(size_t index = nextPuzzleRunIndex++; index < puzzleRuns.size(); index = nextPuzzleRunIndex++)
+				{
+					const PuzzleRun& puzzleRun = puzzleRuns[index];
+					const ScopedTraceSpan puzzleSpan{puzzleRun.puzzleSolution_->puzzleId_.data(), static_cast<int64_t>(index)};
+					const auto startTime = chrono::steady_clock::now();
+
+					results[index].puzzleId_ = puzzleRun.puzzleSolution_->puzzleId_;
+
+					try
+					{
+						results[index].answers_ = puzzleRun.puzzleSolution_->createPuzzleSolution_()->solve(puzzleRun.puzzleInputFilePath_);
+					}
+					catch(const exception& exception)
+					{
+						results[index].error_ = exception.what();
+					}
+
+					results[index].duration_ = chrono::steady_clock::now() - startTime;
+				}
+			});
+		}
+		catch(...)
+		{
+			panicThrows_ = panicThrows;
+
+			throw;
+		}
+
+		panicThrows_ = panicThrows;
+
+		return results;
+	}
+
+	vector<string> expandBatchInputPaths(const vector<string>& batchInputPaths)
+	{
+		vector<string> puzzleInputFilePaths;
+
+		for(const string& batchInputPath : batchInputPaths)
+		{
+			if(batchInputPath.starts_with('@'))
+			{
+				ifstream fileStream{batchInputPath.substr(1)};
+
+				if(!fileStream.is_open())
+					panic(format("unable to open list file: \"{}\"", batchInputPath.substr(1)));
+
+				for(string line; getline(fileStream, line);)
+					if(!line.empty())
+						puzzleInputFilePaths.push_back(std::move(line));
+			}
+			else if(filesystem::is_directory(batchInputPath))
+			{
+				vector<string> directoryFilePaths;
+
+				for(const filesystem::directory_entry& entry : filesystem::directory_iterator(batchInputPath))
+					if(entry.is_regular_file())
+						directoryFilePaths.push_back(entry.path().string());
+
+				sort(directoryFilePaths.begin(), directoryFilePaths.end());
+
+				puzzleInputFilePaths.insert(puzzleInputFilePaths.end(), directoryFilePaths.begin(), directoryFilePaths.end());
+			}
+			else
+			{
+				puzzleInputFilePaths.push_back(batchInputPath);
+			}
+		}
+
+		return puzzleInputFilePaths;
+	}
+
+	vector<PuzzleRunResult> solvePuzzleBatch(const RegisteredPuzzleSolution& puzzleSolution,
+	                                         const vector<string>& puzzleInputFilePaths,
+	                                         unsigned numThreads)
+	{
+		AOC_ASSERT(numThreads > 0);
+
+		vector<PuzzleRunResult> results(puzzleInputFilePaths.size());
+		atomic<size_t> nextInputIndex{0};
+
+		// A malformed input fails on its own instead of ending the batch.
+		const bool panicThrows = panicThrows_.exchange(true);
+
+		try
+		{
+			parallelFor(min<size_t>(numThreads, puzzleInputFilePaths.size()), [&](size_t)
+			{
+				unique_ptr<PuzzleSolution> solution = puzzleSolution.createPuzzleSolution_();
+
+				for(size_t index = nextInputIndex++; index < puzzleInputFilePaths.size(); index = nextInputIndex++)
+				{
+					const ScopedTraceSpan inputSpan{"batch input", static_cast<int64_t>(index)};
+					const auto startTime = chrono::steady_clock::now();
+
+					results[index].puzzleId_ = puzzleSolution.puzzleId_;
+
+					try
+					{
+						results[index].answers_ = solution->solve(puzzleInputFilePaths[index]);
+					}
+					catch(const exception& exception)
+					{
+						results[index].error_ = exception.what();
+
+						// The instance may have been left half-way through its input.
+						solution = puzzleSolution.createPuzzleSolution_();
+					}
+
+					results[index].duration_ = chrono::steady_clock::now() - startTime;
+				}
+			});
+		}
+		catch(...)
+		{
+			panicThrows_ = panicThrows;
+
+			throw;
+		}
+
+		panicThrows_ = panicThrows;
+
+		return results;
+	}
+
+#if !defined(_WIN32)
+	// Buffered reading and writing of a connected socket.
+	class SocketStream
+	{
+	public:
+		explicit SocketStream(int socketDescriptor) : socketDescriptor_(socketDescriptor) {}
+
+	public:
+		// Returns false at the end of the stream (a partial last line is
+		// discarded).
+		bool readLine(string& line);
+		bool readBytes(size_t numBytes,
+		               string& bytes);
+		bool write(std::string_view text);
+
+	private:
+		bool fill();
+
+	private:
+		int socketDescriptor_;
+		string buffer_;
+		size_t bufferPos_ = 0;
+	};
+
+	bool SocketStream::fill()
+	{
+		buffer_.erase(0, bufferPos_);
+		bufferPos_ = 0;
+
+		char chunk[64 * 1024];
+		ssize_t numReadBytes;
+
+		do
+		{
+			numReadBytes = recv(socketDescriptor_, chunk, sizeof(chunk), 0);
+		}
+		while((numReadBytes == -1) && (errno == EINTR));
+
+		if(numReadBytes <= 0)
+			return false;
+
+		buffer_.append(chunk, static_cast<size_t>(numReadBytes));
+
+		return true;
+	}
+
+	bool SocketStream::readLine(string& line)
+	{
+		size_t lineEndPos;
+
+		while((lineEndPos = buffer_.find('\n', bufferPos_)) == string::npos)
+			if((buffer_.size() - bufferPos_ > maxRequestLineSize) || !fill())
+				return false;
+
+		line.assign(buffer_, bufferPos_, lineEndPos - bufferPos_);
+		bufferPos_ = lineEndPos + 1;
+
+		return true;
+	}
+
+	bool SocketStream::readBytes(size_t numBytes,
+	                             string& bytes)
+	{
+		while(buffer_.size() - bufferPos_ < numBytes)
+			if(!fill())
+				return false;
+
+		bytes.assign(buffer_, bufferPos_, numBytes);
+		bufferPos_ += numBytes;
+
+		return true;
+	}
+
+	bool SocketStream::write(std::string_view text)
+	{
+#if defined(MSG_NOSIGNAL)
+		constexpr int flags = MSG_NOSIGNAL;
+#else
+		constexpr int flags = 0;
+#endif
+
+		while(!text.empty())
+		{
+			const ssize_t numWrittenBytes = send(socketDescriptor_, text.data(), text.size(), flags);
+
+			if(numWrittenBytes == -1)
+			{
+				if(errno == EINTR)
+					continue;
+
+				return false;
+			}
+
+			text.remove_prefix(static_cast<size_t>(numWrittenBytes));
+		}
+
+		return true;
+	}
+
+	class PuzzleServerWorker
+	{
+	public:
+		// Returns false once a shutdown has been requested.
+		bool serveConnection(int socketDescriptor);
+
+	private:
+		string solve(std::string_view puzzleId,
+		             const function<array<int, 2>(PuzzleSolution&)>& solvePuzzle);
+
+	private:
+		vector<pair<std::string_view, unique_ptr<PuzzleSolution>>> puzzleSolutions_;
+	};
+
+	string PuzzleServerWorker::solve(std::string_view puzzleId,
+	                                 const function<array<int, 2>(PuzzleSolution&)>& solvePuzzle)
+	{
+		const RegisteredPuzzleSolution* registeredPuzzleSolution = findRegisteredPuzzleSolution(puzzleId);
+
+		if(!registeredPuzzleSolution)
+			return format("error unknown puzzle: '{}'\n", puzzleId);
+
+		auto position = find_if(puzzleSolutions_.begin(), puzzleSolutions_.end(),
+		                        [&](const auto& puzzleSolution) { return puzzleSolution.first == puzzleId; });
+
+		if(position == puzzleSolutions_.end())
+		{
+			puzzleSolutions_.emplace_back(registeredPuzzleSolution->puzzleId_, registeredPuzzleSolution->createPuzzleSolution_());
+			position = puzzleSolutions_.end() - 1;
+		}
+
+		try
+		{
+			const array<int, 2> answers = solvePuzzle(*position->second);
+
+			return format("ok {} {}\n", answers[0], answers[1]);
+		}
+		catch(const exception& exception)
+		{
+			// The instance may have been left half-way through its input.
+			puzzleSolutions_.erase(position);
+
+			return format("error {}\n", exception.what());
+		}
+	}
+
+	bool PuzzleServerWorker::serveConnection(int socketDescriptor)
+	{
+		SocketStream socketStream{socketDescriptor};
+		string request;
+
+		while(socketStream.readLine(request))
+		{
+			const vector<std::string_view> words = [&]
+			{
+				vector<std::string_view> words;
+				std::string_view remainder = request;
+
+				while(!remainder.empty())
+				{
+					const size_t wordEndPos = remainder.find(' ');
+
+					if(wordEndPos > 0)
+						words.push_back(remainder.substr(0, wordEndPos));
+
+					remainder.remove_prefix((wordEndPos != std::string_view::npos) ? wordEndPos + 1 : remainder.size());
+				}
+
+				return words;
+			}();
+
+			string response;
+
+			if((words.size() == 1) && (words[0] == "shutdown"))
+			{
+				socketStream.write("ok\n");
+
+				return false;
+			}
+			else if((words.size() == 3) && (words[0] == "solve"))
+			{
+				const string puzzleInputFilePath{words[2]};
+
+				response = solve(words[1], [&](PuzzleSolution& puzzleSolution) { return puzzleSolution.solve(puzzleInputFilePath); });
+			}
+			else if((words.size() == 3) && (words[0] == "solve-inline"))
+			{
+				size_t numBytes = 0;
+				const auto [end, error] = from_chars(words[2].data(), words[2].data() + words[2].size(), numBytes);
+
+				if((error != errc()) || (end != words[2].data() + words[2].size()))
+				{
+					response = format("error invalid payload size: '{}'\n", words[2]);
+				}
+				else if(numBytes > maxInlinePayloadSize)
+				{
+					// The payload is not read, so the stream cannot be
+					// resynchronised.
+					socketStream.write(format("error payload too large: {} bytes (at most {})\n", numBytes, maxInlinePayloadSize));
+
+					break;
+				}
+				else
+				{
+					string payload;
+
+					if(!socketStream.readBytes(numBytes, payload))
+						break;
+
+					// Solved from memory, without a round trip through a file.
+					response = solve(words[1], [&](PuzzleSolution& puzzleSolution) { return puzzleSolution.solveText(std::move(payload)); });
+				}
+			}
+			else
+			{
+				response = format("error invalid request: '{}'\n", request);
+			}
+
+			if(!socketStream.write(response))
+				break;
+		}
+
+		return true;
+	}
+#endif
+
+	void servePuzzleSolutions(const string& socketPath,
+	                          unsigned numThreads)
+	{
+		AOC_ASSERT(numThreads > 0);
+
+#if defined(_WIN32)
+		panic("the puzzle server is not supported on Windows");
+#else
+		sockaddr_un address{};
+
+		address.sun_family = AF_UNIX;
+
+		if(socketPath.size() >= sizeof(address.sun_path))
+			panic(format("socket path too long: \"{}\"", socketPath));
+
+		socketPath.copy(address.sun_path, socketPath.size());
+
+		const int listeningSocketDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+
+		if(listeningSocketDescriptor == -1)
+			panic(format("unable to create socket: {}", strerror(errno)));
+
+		unlink(socketPath.c_str());
+
+		if((bind(listeningSocketDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1) ||
+		   (listen(listeningSocketDescriptor, SOMAXCONN) == -1))
+		{
+			const int error = errno;
+
+			close(listeningSocketDescriptor);
+
+			panic(format("unable to listen on socket \"{}\": {}", socketPath, strerror(error)));
+		}
+
+		const bool panicThrows = panicThrows_.exchange(true);
+		atomic<bool> stopped{false};
+		atomic<int> acceptError{0};
+
+		parallelFor(numThreads, [&](size_t)
+		{
+			PuzzleServerWorker worker;
+
+			while(!stopped)
+			{
+				const int socketDescriptor = accept(listeningSocketDescriptor, nullptr, nullptr);
+
+				if(socketDescriptor == -1)
+				{
+					const int error = errno;
+
+					if(stopped || (error == EINTR) || (error == ECONNABORTED))
+						continue;
+
+					// Running out of descriptors or memory may pass once
+					// other connections are closed; retrying at once would
+					// only spin.
+					if((error == EMFILE) || (error == ENFILE) || (error == ENOBUFS) || (error == ENOMEM))
+					{
+						this_thread::sleep_for(chrono::milliseconds(100));
+						continue;
+					}
+
+					acceptError = error;
+					stopped = true;
+					shutdown(listeningSocketDescriptor, SHUT_RDWR);
+
+					continue;
+				}
+
+				if(!worker.serveConnection(socketDescriptor))
+				{
+					// Wakes up the workers blocked in accept().
+					stopped = true;
+					shutdown(listeningSocketDescriptor, SHUT_RDWR);
+				}
+
+				close(socketDescriptor);
+			}
+		});
+
+		panicThrows_ = panicThrows;
+
+		close(listeningSocketDescriptor);
+		unlink(socketPath.c_str());
+
+		if(acceptError != 0)
+			panic(format("unable to accept connections on socket \"{}\": {}", socketPath, strerror(acceptError)));
+#endif
+	}
+
+}
+
+#if defined(AOC_TRACK_ALLOCATIONS)
+
+void* operator new(size_t size) { return aoc::allocateTrackedOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return aoc::allocateTrackedOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, align_val_t alignment) { return aoc::allocateTrackedOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, align_val_t alignment) { return aoc::allocateTrackedOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, const nothrow_t&) noexcept { return aoc::allocateTracked(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return aoc::allocateTracked(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, align_val_t alignment, const nothrow_t&) noexcept { return aoc::allocateTracked(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, align_val_t alignment, const nothrow_t&) noexcept { return aoc::allocateTracked(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { aoc::deallocateTracked(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pointer) noexcept { aoc::deallocateTracked(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pointer, size_t) noexcept { aoc::deallocateTracked(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pointer, size_t) noexcept { aoc::deallocateTracked(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pointer, align_val_t alignment) noexcept { aoc::deallocateTracked(pointer, static_cast<size_t>(alignment)); }
+void operator delete[](void* pointer, align_val_t alignment) noexcept { aoc::deallocateTracked(pointer, static_cast<size_t>(alignment)); }
+void operator delete(void* pointer, size_t, align_val_t alignment) noexcept { aoc::deallocateTracked(pointer, static_cast<size_t>(alignment)); }
+void operator delete[](void* pointer, size_t, align_val_t alignment) noexcept { aoc::deallocateTracked(pointer, static_cast<size_t>(alignment)); }
+void operator delete(void* pointer, const nothrow_t&) noexcept { aoc::deallocateTracked(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pointer, const nothrow_t&) noexcept { aoc::deallocateTracked(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pointer, align_val_t alignment, const nothrow_t&) noexcept { aoc::deallocateTracked(pointer, static_cast<size_t>(alignment)); }
+void operator delete[](void* pointer, align_val_t alignment, const nothrow_t&) noexcept { aoc::deallocateTracked(pointer, static_cast<size_t>(alignment)); }
+
+#endif
+
+#if defined(AOC_TEST)
+
+namespace aoc
+{
+	TEST_CASE("isInRange")
+	{
+		CHECK(isInRange(1, 1, 10) == true);
+		CHECK(isInRange(5, 1, 10) == true);
+		CHECK(isInRange(10, 1, 10) == true);
+		CHECK(isInRange(0, 1, 10) == false);
+		CHECK(isInRange(11, 1, 10) == false);
+		CHECK(isInRange(-10, 1, 10) == false);
+		CHECK(isInRange(20, 1, 10) == false);
+		CHECK(isInRange(3, -1, 3) == true);
+	}
+
+	TEST_CASE("checkedAnswer")
+	{
+		CHECK(checkedAnswer(0) == 0);
+		CHECK(checkedAnswer(INT_MAX) == INT_MAX);
+		CHECK(checkedAnswer(INT_MIN) == INT_MIN);
+		CHECK_THROWS_WITH_AS(checkedAnswer(int64_t(INT_MAX) + 1), "answer does not fit an int: 2147483648", runtime_error);
+		CHECK_THROWS_WITH_AS(checkedAnswer(int64_t(INT_MIN) - 1), "answer does not fit an int: -2147483649", runtime_error);
+	}
+
+	TEST_CASE("numParallelTasks")
+	{
+		const unsigned numThreads = numWorkerThreads();
+
+		setNumWorkerThreads(4);
+
+		CHECK(numParallelTasks(0) == 1);
+		CHECK(numParallelTasks(1000) == 1);
+		CHECK(numParallelTasks(3 << 20) == 3);
+		CHECK(numParallelTasks(100 << 20) == 4);
+
+		setNumWorkerThreads(numThreads);
+	}
+
+	TEST_CASE("parallelFor")
+	{
+		vector<size_t> results(5);
+
+		parallelFor(results.size(), [&](size_t taskIndex) { results[taskIndex] = taskIndex * taskIndex; });
+
+		CHECK(results == vector<size_t>{ 0, 1, 4, 9, 16 });
+
+		CHECK_THROWS_WITH_AS(parallelFor(4, [](size_t taskIndex)
+		                     {
+		                         if(taskIndex >= 2)
+		                             panic(format("task {} failed", taskIndex));
+		                     }),
+		                     "task 2 failed",
+		                     runtime_error);
+	}
+
+	TEST_CASE("splitIntoLineAlignedRanges")
+	{
+		CHECK(splitIntoLineAlignedRanges("", 1) == vector<std::string_view>{ "" });
+		CHECK(splitIntoLineAlignedRanges("", 2) == vector<std::string_view>{ "", "" });
+		CHECK(splitIntoLineAlignedRanges("abc\ndef\n", 1) == vector<std::string_view>{ "abc\ndef\n" });
+		CHECK(splitIntoLineAlignedRanges("abc\ndef\n", 2) == vector<std::string_view>{ "abc\n", "def\n" });
+		CHECK(splitIntoLineAlignedRanges("abc\ndef\nghi", 3) == vector<std::string_view>{ "abc\n", "def\n", "ghi" });
+		CHECK(splitIntoLineAlignedRanges("abcdefgh\ni\nj\n", 4) == vector<std::string_view>{ "abcdefgh\n", "i\n", "j\n", "" });
+		CHECK(splitIntoLineAlignedRanges("abcdefgh", 3) == vector<std::string_view>{ "abcdefgh", "", "" });
+	}
+
+	TEST_CASE("indexLines")
+	{
+		CHECK(indexLines("") == vector<size_t>{ 0 });
+		CHECK(indexLines("\n") == vector<size_t>{ 0, 1 });
+		CHECK(indexLines("abc") == vector<size_t>{ 0, 4 });
+		CHECK(indexLines("abc\n") == vector<size_t>{ 0, 4 });
+		CHECK(indexLines("abc\ndef") == vector<size_t>{ 0, 4, 8 });
+		CHECK(indexLines("abc\n\ndef\n") == vector<size_t>{ 0, 4, 5, 9 });
+
+		string text;
+
+		for(size_t i=0; i<300; ++i)
+			text += ((i * i) % 7 == 3) ? '\n' : 'a';
+
+		for(int instructionSet=0; instructionSet<=static_cast<int>(detectInstructionSet()); ++instructionSet)
+		{
+			CAPTURE(instructionSetName(InstructionSet(instructionSet)));
+
+			for(size_t length=0; length<=text.size(); ++length)
+				CHECK(indexLines(std::string_view(text).substr(0, length), InstructionSet(instructionSet)) ==
+				      indexLines(std::string_view(text).substr(0, length), InstructionSet::Scalar));
+
+			CHECK(indexLines(string(100, '\n'), InstructionSet(instructionSet)).size() == 101);
+		}
+	}
+
+	TEST_CASE("indexLinesInParallel")
+	{
+		for(const char* text : { "", "\n", "abc", "abc\n", "abc\n\ndef", "467..114..\n...*......\n..35..633.\n", "abcdefgh\ni\nj\n" })
+		{
+			CAPTURE(text);
+
+			for(size_t numTasks=1; numTasks<=6; ++numTasks)
+				CHECK(indexLinesInParallel(text, numTasks) == indexLines(text, InstructionSet::Scalar));
+		}
+	}
+
+	TEST_CASE("LineArena")
+	{
+		const LineArena lineArena1;
+
+		CHECK(lineArena1.empty());
+		CHECK(lineArena1.begin() == lineArena1.end());
+
+		const LineArena lineArena2(string("abc\n\ndef"));
+
+		CHECK(lineArena2.size() == 3);
+		CHECK(lineArena2[0] == "abc");
+		CHECK(lineArena2[1] == "");
+		CHECK(lineArena2[2] == "def");
+		CHECK(vector<std::string_view>(lineArena2.begin(), lineArena2.end()) == vector<std::string_view>{ "abc", "", "def" });
+		CHECK_THROWS_WITH_AS(lineArena2[3], "assertion failed with condition 'index < size()'", runtime_error);
+		CHECK(lineArena2.findFirstLineAtOrAfter(0) == 0);
+		CHECK(lineArena2.findFirstLineAtOrAfter(1) == 1);
+		CHECK(lineArena2.findFirstLineAtOrAfter(4) == 1);
+		CHECK(lineArena2.findFirstLineAtOrAfter(5) == 2);
+		CHECK(lineArena2.findFirstLineAtOrAfter(6) == 3);
+		CHECK(lineArena2.findFirstLineAtOrAfter(8) == 3);
+
+		const LineArena lineArena3 = { "467..114..", "...*......" };
+
+		CHECK(lineArena3.size() == 2);
+		CHECK(lineArena3.text() == "467..114..\n...*......\n");
+		CHECK(lineArena3[1] == "...*......");
+	}
+
+	TEST_CASE("ChunkReader")
+	{
+		const string filePath = (filesystem::temp_directory_path() / "aoc-test-chunked-input.txt").string();
+
+		for(const string& text : { string(), string("abc"), string("467..114..\n...*......\n..35..633.\n"), string(1000, '(') })
+		{
+			{
+				ofstream fileStream{filePath, ios::binary | ios::trunc};
+				fileStream << text;
+			}
+
+			for(size_t chunkSize : { 1, 3, 10, 64 })
+			{
+				for(size_t numChunks : { 1, 2, 3 })
+				{
+					ChunkReader chunkReader{filePath, chunkSize, numChunks};
+					string readText;
+
+					for(std::string_view chunk = chunkReader.nextChunk(); !chunk.empty(); chunk = chunkReader.nextChunk())
+					{
+						CHECK(chunk.size() <= chunkSize);
+						readText += chunk;
+					}
+
+					CHECK(readText == text);
+					CHECK(chunkReader.nextChunk().empty());
+				}
+			}
+		}
+
+		{
+			ChunkReader chunkReader{filePath, 1};
+
+			CHECK(chunkReader.nextChunk() == "(");
+		}
+
+		// The buffers are no larger than the file.
+		{
+			const size_t outerPeakLiveBytes = resetPeakLiveBytes();
+			const size_t liveBytes = readAllocationStatistics().peakLiveBytes_;
+
+			{
+				ChunkReader chunkReader{filePath, size_t(1) << 30};
+
+				CHECK(chunkReader.nextChunk() == string(1000, '('));
+				CHECK(chunkReader.nextChunk().empty());
+			}
+
+			const size_t peakLiveBytes = resetPeakLiveBytes();
+
+			restorePeakLiveBytes(peakLiveBytes);
+			restorePeakLiveBytes(outerPeakLiveBytes);
+
+			if(allocationTrackingEnabled())
+				CHECK(peakLiveBytes - liveBytes < 64 * 1024);
+		}
+
+		filesystem::remove(filePath);
+
+		CHECK_THROWS_WITH_AS(ChunkReader(filePath, 64),
+		                     format("unable to open input file: \"{}\"", filePath).c_str(),
+		                     runtime_error);
+	}
+
+	TEST_CASE("parseLines")
+	{
+		const LineArena lines = { "1", "22", "", "333", "4444", "55555" };
+
+		for(size_t numTasks=1; numTasks<=8; ++numTasks)
+			CHECK(parseLines(lines, [](std::string_view line) { return line.size(); }, numTasks) == vector<size_t>{ 1, 2, 0, 3, 4, 5 });
+
+		CHECK(parseLines(LineArena{}, [](std::string_view line) { return line.size(); }).empty());
+		CHECK_THROWS_WITH_AS(parseLines(lines,
+		                                [](std::string_view line)
+		                                {
+		                                    AOC_ASSERT_MSG(line.size() < 3, format("line too long: '{}'", line));
+
+		                                    return line.size();
+		                                },
+		                                4),
+		                     "line too long: '333'",
+		                     runtime_error);
+	}
+
+	TEST_CASE("loadBufferedPuzzleInput and loadMappedPuzzleInput")
+	{
+		const string filePath = (filesystem::temp_directory_path() / "aoc-test-mapped-input.txt").string();
+
+		{
+			ofstream fileStream{filePath, ios::binary};
+			fileStream << "467..114..\n...*......\n..35..633.\n";
+		}
+
+		const LineArena mappedInput = loadMappedPuzzleInput(filePath);
+		const LineArena bufferedInput = loadBufferedPuzzleInput(filePath);
+
+		CHECK(mappedInput.text().size() == 33);
+		CHECK(vector<std::string_view>(mappedInput.begin(), mappedInput.end()) == vector<std::string_view>{ "467..114..", "...*......", "..35..633." });
+		CHECK(vector<string>(mappedInput.begin(), mappedInput.end()) == loadPuzzleInput(filePath));
+		CHECK(vector<string>(bufferedInput.begin(), bufferedInput.end()) == loadPuzzleInput(filePath));
+
+		string buffer;
+		buffer.reserve(1000);
+		const char* bufferData = buffer.data();
+
+		LineArena reusingInput = loadBufferedPuzzleInput(filePath, std::move(buffer));
+
+		CHECK(vector<string>(reusingInput.begin(), reusingInput.end()) == loadPuzzleInput(filePath));
+		CHECK(reusingInput.text().data() == bufferData);
+
+		const string releasedBuffer = reusingInput.releaseBuffer();
+
+		CHECK(releasedBuffer.data() == bufferData);
+		CHECK(reusingInput.empty());
+		CHECK(reusingInput.text().empty());
+		CHECK(LineArena(MappedFile(filePath)).releaseBuffer().empty());
+
+		{
+			ofstream fileStream{filePath, ios::binary | ios::trunc};
+		}
+
+		CHECK(loadMappedPuzzleInput(filePath).empty());
+		CHECK(loadBufferedPuzzleInput(filePath).empty());
+
+		filesystem::remove(filePath);
+
+		CHECK_THROWS_WITH_AS(loadMappedPuzzleInput(filePath),
+		                     format("unable to open input file: \"{}\"", filePath).c_str(),
+		                     runtime_error);
+		CHECK_THROWS_WITH_AS(loadBufferedPuzzleInput(filePath),
+		                     format("unable to open input file: \"{}\"", filePath).c_str(),
+		                     runtime_error);
+	}
+
+#if !defined(_WIN32)
+	TEST_CASE("loadBufferedPuzzleInput from a pipe")
+	{
+		const string fifoPath = (filesystem::temp_directory_path() / "aoc-test-input.fifo").string();
+
+		filesystem::remove(fifoPath);
+		REQUIRE(mkfifo(fifoPath.c_str(), 0600) == 0);
+
+		const string text = string(100000, '(') + "\n)\n";
+
+		thread writer([&]()
+		{
+			ofstream fileStream{fifoPath, ios::binary};
+			fileStream << text;
+		});
+
+		const LineArena input = loadBufferedPuzzleInput(fifoPath);
+
+		writer.join();
+		filesystem::remove(fifoPath);
+
+		CHECK(input.text() == text);
+		CHECK(input.size() == 2);
+	}
+#endif
+
+	class LineRecorder : public StreamingPuzzleSolution
+	{
+	public:
+		explicit LineRecorder(size_t chunkSize) : StreamingPuzzleSolution(chunkSize) {}
+
+	public:
+		vector<string> record(const string& puzzleInputFilePath)
+		{
+			lines_.clear();
+			processInput(puzzleInputFilePath);
+
+			return lines_;
+		}
+
+		vector<string> recordText(string text)
+		{
+			lines_.clear();
+			processText(std::move(text));
+
+			return lines_;
+		}
+
+	private:
+		void processLine(std::string_view line) override { lines_.emplace_back(line); }
+		int answer1() override { return 0; }
+		int answer2() override { return 0; }
+
+	private:
+		vector<string> lines_;
+	};
+
+	TEST_CASE("PhaseTimings")
+	{
+		PhaseTimings phaseTimings;
+
+		CHECK(phaseTimings.enabled() == false);
+
+		{
+			ScopedPhaseTimer loadTimer{phaseTimings, Phase::Load};
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+
+		CHECK(phaseTimings.duration(Phase::Load) == PhaseTimings::Duration::zero());
+
+		phaseTimings.setEnabled(true);
+
+		{
+			ScopedPhaseTimer loadTimer{phaseTimings, Phase::Load};
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+
+		CHECK(phaseTimings.duration(Phase::Load) >= chrono::milliseconds(1));
+		CHECK(phaseTimings.duration(Phase::Parse) == PhaseTimings::Duration::zero());
+
+		phaseTimings.reset();
+		phaseTimings.add(Phase::Parse, chrono::microseconds(1500));
+		phaseTimings.add(Phase::Total, chrono::seconds(2));
+
+		CHECK(phaseTimings.toJson() == R"({"load_ns":0,"parse_ns":1500000,"answer1_ns":0,"answer2_ns":0,"total_ns":2000000000})");
+
+		CHECK(phaseTimings.toString() ==
+		      "load            0.000 ms\n"
+		      "parse           1.500 ms\n"
+		      "answer1         0.000 ms\n"
+		      "answer2         0.000 ms\n"
+		      "total        2000.000 ms\n");
+
+		phaseTimings.addCounters(Phase::Parse, { 1000.0, 2500.0, 100.0, 5.0, 400.0, 40.0 });
+		phaseTimings.addCounters(Phase::Load, { 200.0, 100.0, 10.0, 1.0, 20.0, 2.0 });
+		phaseTimings.addCounters(Phase::Parse, { 200.0, 100.0, 10.0, 1.0, 20.0, 2.0 });
+		phaseTimings.excludeNestedPhase(Phase::Parse, Phase::Load);
+
+		CHECK(phaseTimings.counters(Phase::Parse) == CounterValues{ 1000.0, 2500.0, 100.0, 5.0, 400.0, 40.0 });
+		CHECK(phaseTimings.duration(Phase::Parse) == chrono::microseconds(1500));
+
+		phaseTimings.setCountersEnabled(true);
+
+		CHECK(phaseTimings.toJson().find(R"("parse_ns":1500000,"parse_cycles":1000,"parse_instructions":2500,"parse_cache_references":100,)"
+		                                 R"("parse_cache_misses":5,"parse_branches":400,"parse_branch_misses":40,)"
+		                                 R"("parse_ipc":2.5,"parse_cache_miss_rate":0.05,"parse_branch_miss_rate":0.1,"answer1_ns")") != string::npos);
+		CHECK(phaseTimings.toString().find("parse              1000           2500   2.50              5    5.00%             40   10.00%\n") != string::npos);
+
+		phaseTimings.reset();
+		phaseTimings.addCounters(Phase::Answer1, { numeric_limits<double>::quiet_NaN(), 10.0, 0.0, 0.0, 0.0, 0.0 });
+
+		CHECK(phaseTimings.toJson().find(R"("answer1_cycles":null,"answer1_instructions":10,)") != string::npos);
+		CHECK(phaseTimings.toJson().find(R"("answer1_ipc":null,"answer1_cache_miss_rate":null,)") != string::npos);
+		CHECK(phaseTimings.toString().find("answer1             n/a             10    n/a              0      n/a              0      n/a\n") != string::npos);
+
+		phaseTimings.reset();
+		phaseTimings.setCountersEnabled(false);
+		phaseTimings.setAllocationsEnabled(true);
+		phaseTimings.addAllocations(Phase::Load, { 2, 100, 100 });
+		phaseTimings.addAllocations(Phase::Parse, { 5, 300, 250 });
+		phaseTimings.addAllocations(Phase::Parse, { 1, 10, 200 });
+		phaseTimings.excludeNestedPhase(Phase::Parse, Phase::Load);
+
+		CHECK(phaseTimings.allocations(Phase::Parse).numAllocations_ == 4);
+		CHECK(phaseTimings.allocations(Phase::Parse).numAllocatedBytes_ == 210);
+		CHECK(phaseTimings.allocations(Phase::Parse).peakLiveBytes_ == 250);
+		CHECK(phaseTimings.toJson().find(R"("parse_ns":0,"parse_allocations":4,"parse_allocated_bytes":210,"parse_peak_live_bytes":250,"answer1_ns")") != string::npos);
+		CHECK(phaseTimings.toString().find("parse                 4              210              250\n") != string::npos);
+		CHECK(phaseTimings.allocationsTracked(Phase::Answer1));
+
+		phaseTimings.setConcurrentAnswers(true);
+
+		CHECK(phaseTimings.allocationsTracked(Phase::Parse));
+		CHECK_FALSE(phaseTimings.allocationsTracked(Phase::Answer1));
+		CHECK_FALSE(phaseTimings.allocationsTracked(Phase::Answer2));
+		CHECK(phaseTimings.toJson().find(R"("answer2_ns":0,"answer2_allocations":null,"answer2_allocated_bytes":null,"answer2_peak_live_bytes":null,"total_ns")") != string::npos);
+		CHECK(phaseTimings.toString().find("answer1             n/a              n/a              n/a\n") != string::npos);
+
+		phaseTimings.setConcurrentAnswers(false);
+
+		phaseTimings.reset();
+		phaseTimings.setAllocationsEnabled(false);
+		phaseTimings.setAnswersInParsePhase(true);
+
+		CHECK(phaseTimings.toJson().ends_with(R"("total_ns":0,"answers_in_parse":true})"));
+		CHECK(phaseTimings.toString().ends_with("total           0.000 ms\nthe answers are computed in the parse phase; answer1 and answer2 only return them\n"));
+	}
+
+	TEST_CASE("readPerformanceCounters")
+	{
+		const CounterValues counters1 = readPerformanceCounters();
+
+		volatile int sum = 0;
+
+		for(int i=0; i<100000; ++i)
+			sum = sum + i;
+
+		const CounterValues counters2 = readPerformanceCounters();
+
+		for(size_t counterEvent=0; counterEvent<numCounterEvents; ++counterEvent)
+		{
+			CAPTURE(counterEventName(CounterEvent(counterEvent)));
+
+			CHECK(isnan(counters1[counterEvent]) == isnan(counters2[counterEvent]));
+
+			if(!isnan(counters1[counterEvent]))
+				CHECK(counters2[counterEvent] >= counters1[counterEvent]);
+		}
+
+		if(isnan(counters1[static_cast<size_t>(CounterEvent::Instructions)]))
+			CHECK(!performanceCountersUnavailabilityReason().empty());
+		else
+			CHECK(counters2[static_cast<size_t>(CounterEvent::Instructions)] - counters1[static_cast<size_t>(CounterEvent::Instructions)] > 100000.0);
+	}
+
+	struct alignas(64) AlignedValue
+	{
+		char bytes_[64];
+	};
+
+	TEST_CASE("readAllocationStatistics")
+	{
+		const AllocationStatistics allocations1 = readAllocationStatistics();
+		const size_t outerPeakLiveBytes = resetPeakLiveBytes();
+
+		{
+			vector<char> buffer(1 << 20);
+			doNotOptimize(buffer.data());
+		}
+
+		const AllocationStatistics allocations2 = readAllocationStatistics();
+
+		{
+			vector<char> buffer(1 << 10);
+			doNotOptimize(buffer.data());
+		}
+
+		const size_t innerPeakLiveBytes = resetPeakLiveBytes();
+		const AllocationStatistics allocations3 = readAllocationStatistics();
+
+		restorePeakLiveBytes(innerPeakLiveBytes);
+		restorePeakLiveBytes(outerPeakLiveBytes);
+
+		if(allocationTrackingEnabled())
+		{
+			CHECK(allocations2.numAllocations_ >= allocations1.numAllocations_ + 1);
+			CHECK(allocations2.numAllocatedBytes_ >= allocations1.numAllocatedBytes_ + (1 << 20));
+			CHECK(allocations2.peakLiveBytes_ >= (1 << 20));
+			CHECK(allocations3.peakLiveBytes_ < allocations2.peakLiveBytes_);
+			CHECK(readAllocationStatistics().peakLiveBytes_ >= allocations2.peakLiveBytes_);
+
+			auto alignedValue = make_unique<AlignedValue>();
+			CHECK(reinterpret_cast<uintptr_t>(alignedValue.get()) % alignof(AlignedValue) == 0);
+			CHECK(readAllocationStatistics().numAllocatedBytes_ >= allocations3.numAllocatedBytes_ + sizeof(AlignedValue));
+		}
+		else
+		{
+			CHECK(allocations2.numAllocations_ == 0);
+			CHECK(allocations2.numAllocatedBytes_ == 0);
+			CHECK(allocations2.peakLiveBytes_ == 0);
+		}
+	}
+
+	TEST_CASE("fitComplexity")
+	{
+		const vector<double> sizes = { 1000.0, 2000.0, 4000.0, 8000.0, 16000.0, 32000.0 };
+
+		const auto fit = [&](auto duration)
+		{
+			vector<double> durations;
+
+			for(size_t i=0; i<sizes.size(); ++i)
+				durations.push_back(duration(sizes[i]) * ((i % 2 == 0) ? 1.02 : 0.98));
+
+			return fitComplexity(sizes, durations);
+		};
+
+		const ComplexityFit linearFit = fit([](double n) { return 3e-6 * n + 0.001; });
+		const ComplexityFit linearithmicFit = fit([](double n) { return 1e-7 * n * log2(n); });
+		const ComplexityFit quadraticFit = fit([](double n) { return 1e-9 * n * n; });
+		const ComplexityFit cubicFit = fit([](double n) { return 1e-12 * n * n * n; });
+		const ComplexityFit sesquiFit = fit([](double n) { return 1e-8 * pow(n, 1.5); });
+
+		CHECK(linearFit.model_ == ComplexityModel::Linear);
+		CHECK(linearFit.exponent_ == doctest::Approx(1.0).epsilon(0.05));
+		CHECK(linearFit.superLinear() == false);
+		CHECK(linearithmicFit.model_ == ComplexityModel::Linearithmic);
+		CHECK(linearithmicFit.superLinear() == false);
+		CHECK(quadraticFit.model_ == ComplexityModel::Quadratic);
+		CHECK(quadraticFit.exponent_ == doctest::Approx(2.0).epsilon(0.05));
+		CHECK(quadraticFit.superLinear() == true);
+		CHECK(cubicFit.model_ == ComplexityModel::Quadratic);
+		CHECK(cubicFit.exponent_ == doctest::Approx(3.0).epsilon(0.05));
+		CHECK(sesquiFit.exponent_ == doctest::Approx(1.5).epsilon(0.05));
+		CHECK(sesquiFit.superLinear() == true);
+
+		CHECK(complexityModelName(ComplexityModel::Linearithmic) == "n log n");
+		CHECK_THROWS_WITH_AS(fitComplexity({ 1.0, 1.0 }, { 1.0, 2.0 }), "at least two distinct sizes expected", runtime_error);
+	}
+
+	TEST_CASE("InputRandom")
+	{
+		InputRandom random1{42};
+		InputRandom random2{42};
+		InputRandom random3{43};
+
+		size_t numDifferences = 0;
+		size_t numChances = 0;
+
+		for(int i=0; i<10000; ++i)
+		{
+			const uint64_t value = random1.uniform(3, 7);
+
+			CHECK(value == random2.uniform(3, 7));
+			CHECK(value >= 3);
+			CHECK(value <= 7);
+
+			numDifferences += (random3.uniform(3, 7) != value);
+
+			const bool chance = random1.chance(0.25);
+
+			CHECK(chance == random2.chance(0.25));
+			numChances += chance;
+		}
+
+		CHECK(numDifferences > 7000);
+		CHECK(numChances > 2300);
+		CHECK(numChances < 2700);
+		CHECK(InputRandom(1).chance(0.0) == false);
+		CHECK(InputRandom(1).chance(1.0) == true);
+
+		// The raw mt19937_64 sequence is specified by the standard.
+		CHECK(InputRandom(5489).uniform(0, numeric_limits<uint64_t>::max() - 1) == 14514284786278117030ULL % numeric_limits<uint64_t>::max());
+	}
+
+	TEST_CASE("GeneratedInputWriter")
+	{
+		ostringstream stream;
+
+		{
+			GeneratedInputWriter writer{stream};
+
+			for(int i=0; i<(3 << 20); ++i)
+				writer.put(static_cast<char>('a' + i % 26));
+
+			writer.append("xyz");
+		}
+
+		CHECK(stream.str().size() == (3 << 20) + 3);
+		CHECK(stream.str().substr(0, 3) == "abc");
+		CHECK(stream.str().substr(stream.str().size() - 4) == format("{}xyz", static_cast<char>('a' + ((3 << 20) - 1) % 26)));
+	}
+
+	TEST_CASE("findKernelDivergence")
+	{
+		const auto generateInputs = [](const InputGeneration& inputGeneration)
+		{
+			vector<string> inputs;
+
+			for(size_t i=0; i<inputGeneration.size_; ++i)
+				inputs.push_back(to_string(inputGeneration.seed_ * 100 + i));
+
+			return inputs;
+		};
+
+		const auto reference = kernelOutcome([](std::string_view input)
+		{
+			if(input == "7")
+				panic("seven");
+
+			return static_cast<int>(input.size());
+		});
+
+		const vector<KernelVariant> variants = {
+			{ "same", reference },
+			{ "silent on 7", kernelOutcome([](std::string_view input) { return static_cast<int>(input.size()); }) },
+			{ "wrong from 300", kernelOutcome([](std::string_view input) { return static_cast<int>(input.size()) + (stoi(string(input)) >= 300 ? 1 : 0); }) }
+		};
+
+		CHECK_FALSE(findKernelDivergence(generateInputs, reference, { variants[0] }, { 10, 20 }, 5).has_value());
+		CHECK_FALSE(findKernelDivergence(generateInputs, reference, {}, { 10 }, 5).has_value());
+
+		const optional<KernelDivergence> divergence1 = findKernelDivergence(generateInputs, reference, variants, { 5, 10 }, 3);
+
+		REQUIRE(divergence1.has_value());
+		CHECK(divergence1->variantName_ == "silent on 7");
+		CHECK(divergence1->inputGeneration_.size_ == 10);
+		CHECK(divergence1->inputGeneration_.seed_ == 0);
+		CHECK(divergence1->input_ == "7");
+		CHECK(divergence1->expected_ == "panic: seven");
+		CHECK(divergence1->actual_ == "1");
+
+		const optional<KernelDivergence> divergence2 = findKernelDivergence(generateInputs, reference, variants, { 5 }, 5);
+
+		REQUIRE(divergence2.has_value());
+		CHECK(divergence2->variantName_ == "wrong from 300");
+		CHECK(divergence2->input_ == "300");
+		CHECK(divergence2->toString() == R"(wrong from 300 diverges from the reference on 3 bytes of input generated with size 5 and seed 3: "300"; expected 3, got 4)");
+
+		CHECK(KernelDivergence{ "v", { 1, 2, {} }, string(300, '\n'), "1", "2" }.toString().find(R"("\n\n)") != string::npos);
+	}
+
+	TEST_CASE("FuzzTarget")
+	{
+		const filesystem::path directoryPath = filesystem::temp_directory_path() / format("aoc-fuzz-{}", getpid());
+
+		filesystem::create_directories(directoryPath);
+
+		{
+			FuzzTarget fuzzTarget{"sleep", directoryPath.string(), 3};
+
+			const auto sleepPerByte = [](std::string_view input)
+			{
+				if(input == "x")
+					panic("rejected");
+
+				this_thread::sleep_for(chrono::milliseconds(2 * input.size()));
+
+				return input.size();
+			};
+
+			for(const char* input : { "a", "abcd", "x", "ab", "abcde", "abc", "abcd" })
+				fuzzTarget.run(input, sleepPerByte);
+
+			CHECK(fuzzTarget.numRuns() == 7);
+			REQUIRE(fuzzTarget.slowestInputs().size() == 3);
+			CHECK(fuzzTarget.slowestInputs()[0].input_ == "abcde");
+			CHECK(fuzzTarget.slowestInputs()[1].input_ == "abcd");
+			CHECK(fuzzTarget.slowestInputs()[2].input_ == "abc");
+			CHECK(fuzzTarget.slowestInputs()[0].duration_ >= chrono::milliseconds(10));
+
+			for(size_t rank=0; rank<3; ++rank)
+			{
+				ifstream fileStream{directoryPath / format("sleep-slowest-{}.txt", rank + 1)};
+				string input;
+
+				getline(fileStream, input);
+
+				CHECK(input == fuzzTarget.slowestInputs()[rank].input_);
+			}
+		}
+
+		filesystem::remove_all(directoryPath);
+	}
+
+	TEST_CASE("mutateFuzzInput")
+	{
+		InputRandom random1{1};
+		InputRandom random2{1};
+		string input1;
+		string input2;
+		bool changed = false;
+
+		for(int i=0; i<1000; ++i)
+		{
+			const string previousInput = input1;
+
+			mutateFuzzInput(input1, random1, 100);
+			mutateFuzzInput(input2, random2, 100);
+
+			CHECK(input1.size() <= 100);
+			changed = changed || (input1 != previousInput);
+		}
+
+		CHECK(input1 == input2);
+		CHECK(changed);
+	}
+
+	TEST_CASE("tracing")
+	{
+		const string filePath = (filesystem::temp_directory_path() / format("aoc-trace-{}.json", getpid())).string();
+
+		CHECK_FALSE(tracingEnabled());
+
+		{
+			ScopedTraceSpan untracedSpan{"untraced"};
+		}
+
+		startTracing(filePath);
+
+		CHECK(tracingEnabled());
+		CHECK_THROWS_WITH_AS(startTracing(filePath), "tracing has already been started", runtime_error);
+
+		{
+			ScopedTraceSpan outerSpan{"outer"};
+
+			parallelFor(3, [](size_t taskIndex)
+			{
+				ScopedTraceSpan taskSpan{"task", static_cast<int64_t>(taskIndex)};
+			});
+		}
+
+		stopTracing();
+
+		CHECK_FALSE(tracingEnabled());
+		CHECK_THROWS_WITH_AS(stopTracing(), "tracing has not been started", runtime_error);
+
+		ifstream fileStream{filePath, ios::binary};
+		const string trace{istreambuf_iterator<char>(fileStream), istreambuf_iterator<char>()};
+
+		const auto countOccurrences = [&](std::string_view text)
+		{
+			size_t numOccurrences = 0;
+
+			for(size_t pos=trace.find(text); pos!=string::npos; pos=trace.find(text, pos + 1))
+				++numOccurrences;
+
+			return numOccurrences;
+		};
+
+		CHECK(trace.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[)"));
+		CHECK(trace.ends_with("]}\n"));
+		CHECK(countOccurrences(R"("ph":"X")") == 4);
+		CHECK(countOccurrences(R"("ph":"M")") == 3);
+		CHECK(countOccurrences(R"("name":"task")") == 3);
+		// Thread indices are handed out in order of the first recorded span,
+		// so the task threads may be numbered before the outer one.
+		CHECK(countOccurrences(R"("name":"outer","ph":"X","pid":)" + to_string(getpid()) + R"(,"tid":)") == 1);
+		CHECK(countOccurrences(R"("args":{"index":2})") == 1);
+		CHECK(countOccurrences("untraced") == 0);
+
+		// A new session starts with fresh buffers and thread indices.
+		startTracing(filePath);
+
+		{
+			ScopedTraceSpan span{"second"};
+		}
+
+		stopTracing();
+
+		ifstream secondFileStream{filePath, ios::binary};
+		const string secondTrace{istreambuf_iterator<char>(secondFileStream), istreambuf_iterator<char>()};
+
+		CHECK(secondTrace.find(R"("name":"second","ph":"X","pid":)" + to_string(getpid()) + R"(,"tid":0,)") != string::npos);
+		CHECK(secondTrace.find("outer") == string::npos);
+
+		filesystem::remove(filePath);
+	}
+
+	TEST_CASE("computeSampleStatistics")
+	{
+		const SampleStatistics sampleStatistics1 = computeSampleStatistics({});
+
+		CHECK(sampleStatistics1.min_ == 0.0);
+		CHECK(sampleStatistics1.standardDeviation_ == 0.0);
+
+		const SampleStatistics sampleStatistics2 = computeSampleStatistics({ 3.0 });
+
+		CHECK(sampleStatistics2.min_ == 3.0);
+		CHECK(sampleStatistics2.median_ == 3.0);
+		CHECK(sampleStatistics2.mean_ == 3.0);
+		CHECK(sampleStatistics2.p99_ == 3.0);
+		CHECK(sampleStatistics2.standardDeviation_ == 0.0);
+
+		const SampleStatistics sampleStatistics3 = computeSampleStatistics({ 4.0, 1.0, 3.0, 2.0 });
+
+		CHECK(sampleStatistics3.min_ == 1.0);
+		CHECK(sampleStatistics3.median_ == 2.5);
+		CHECK(sampleStatistics3.mean_ == 2.5);
+		CHECK(sampleStatistics3.p99_ == 4.0);
+		CHECK(sampleStatistics3.standardDeviation_ == doctest::Approx(1.2909944));
+
+		vector<double> samples;
+
+		for(int i=200; i>=1; --i)
+			samples.push_back(i);
+
+		CHECK(computeSampleStatistics(samples).p99_ == 198.0);
+		CHECK(computeSampleStatistics(samples).median_ == 100.5);
+	}
+
+	TEST_CASE("mannWhitneyPValue")
+	{
+		CHECK(mannWhitneyPValue({}, { 1.0 }) == 1.0);
+		CHECK(mannWhitneyPValue({ 1.0, 1.0 }, { 1.0, 1.0 }) == 1.0);
+
+		vector<double> baselineSamples;
+		vector<double> slowerSamples;
+		vector<double> similarSamples;
+
+		for(int i=0; i<30; ++i)
+		{
+			baselineSamples.push_back(10.0 + (i % 5));
+			slowerSamples.push_back(12.0 + (i % 5));
+			similarSamples.push_back(10.0 + ((i + 2) % 5));
+		}
+
+		CHECK(mannWhitneyPValue(baselineSamples, slowerSamples) < 0.01);
+		CHECK(mannWhitneyPValue(slowerSamples, baselineSamples) > 0.99);
+		CHECK(mannWhitneyPValue(baselineSamples, similarSamples) > 0.4);
+
+		// Complete separation of 3 against 3 samples: U = 9, sigma^2 = 5.25.
+		CHECK(mannWhitneyPValue({ 1.0, 2.0, 3.0 }, { 4.0, 5.0, 6.0 }) == doctest::Approx(0.5 * erfc(4.0 / sqrt(5.25) / sqrt(2.0))));
+	}
+
+	TEST_CASE("benchmark baselines")
+	{
+		const string filePath = (filesystem::temp_directory_path() / format("aoc-baseline-{}.txt", getpid())).string();
+
+		BenchmarkSamples baselineSamples;
+		BenchmarkSamples samples;
+
+		for(int i=0; i<30; ++i)
+		{
+			baselineSamples[size_t(Phase::Load)].push_back(1.0 + 0.01 * i);
+			baselineSamples[size_t(Phase::Parse)].push_back(0.1 / 3.0 + 0.01 * (i % 7));
+			baselineSamples[size_t(Phase::Answer1)].push_back(0.0001 * (1 + i % 3));
+
+			samples[size_t(Phase::Load)].push_back(1.5 + 0.01 * i);
+			samples[size_t(Phase::Parse)].push_back(0.1 / 3.0 + 0.01 * ((i + 3) % 7));
+			samples[size_t(Phase::Answer1)].push_back(0.0005 * (1 + i % 3));
+		}
+
+		saveBenchmarkBaseline(filePath, baselineSamples, "test");
+
+		const BenchmarkSamples loadedSamples = loadBenchmarkBaseline(filePath);
+
+		CHECK(loadedSamples == baselineSamples);
+
+		const array<PhaseComparison, numPhases> phaseComparisons = compareWithBaseline(loadedSamples, samples, 0.1);
+
+		// Only the load phase is slower by a margin that matters; answer 1 is
+		// five times slower but by less than a microsecond.
+		CHECK(phaseComparisons[size_t(Phase::Load)].regression_);
+		CHECK(phaseComparisons[size_t(Phase::Load)].median_ == doctest::Approx(1.645));
+		CHECK(phaseComparisons[size_t(Phase::Load)].baselineMedian_ == doctest::Approx(1.145));
+		CHECK_FALSE(phaseComparisons[size_t(Phase::Parse)].regression_);
+		CHECK(phaseComparisons[size_t(Phase::Answer1)].pValue_ < 0.01);
+		CHECK_FALSE(phaseComparisons[size_t(Phase::Answer1)].regression_);
+		CHECK_FALSE(phaseComparisons[size_t(Phase::Answer2)].regression_);
+		CHECK_FALSE(compareWithBaseline(loadedSamples, samples, 0.5)[size_t(Phase::Load)].regression_);
+
+		{
+			ofstream fileStream{filePath, ios::binary | ios::trunc};
+
+			fileStream << "# comment\nload 1.0 x\n";
+		}
+
+		CHECK_THROWS_WITH_AS(loadBenchmarkBaseline(filePath), doctest::Contains("invalid sample in baseline file"), runtime_error);
+
+		{
+			ofstream fileStream{filePath, ios::binary | ios::trunc};
+
+			fileStream << "unknown 1.0\n";
+		}
+
+		CHECK_THROWS_WITH_AS(loadBenchmarkBaseline(filePath), doctest::Contains("unknown phase in baseline file"), runtime_error);
+
+		filesystem::remove(filePath);
+	}
+
+	TEST_CASE("parseRunOptions")
+	{
+		const auto parse = [](vector<string> arguments)
+		{
+			vector<char*> argv;
+
+			for(auto& argument : arguments)
+				argv.push_back(argument.data());
+
+			return parseRunOptions(static_cast<int>(argv.size()), argv.data(), "202303.txt");
+		};
+
+		CHECK(parse({ "202303" }).puzzleInputFilePath_ == "202303.txt");
+		CHECK(parse({ "202303" }).timingsReport_ == TimingsReport::None);
+		CHECK(parse({ "202303", "input.txt" }).puzzleInputFilePath_ == "input.txt");
+		CHECK(parse({ "202303", "--timings" }).timingsReport_ == TimingsReport::Text);
+		CHECK(parse({ "202303", "--timings=json", "input.txt" }).timingsReport_ == TimingsReport::Json);
+		CHECK(parse({ "202303", "input.txt", "--timings=text" }).puzzleInputFilePath_ == "input.txt");
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--timings=xml" }), "invalid timings report: 'xml'", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--verbose" }), "unknown option: '--verbose'", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "a.txt", "b.txt" }), "unexpected argument: 'b.txt'", runtime_error);
+		CHECK(parse({ "202303" }).performanceCounters_ == false);
+		CHECK(parse({ "202303", "--counters" }).performanceCounters_ == true);
+		CHECK(parse({ "202303", "--counters" }).timingsReport_ == TimingsReport::Text);
+		CHECK(parse({ "202303", "--counters", "--timings=json" }).timingsReport_ == TimingsReport::Json);
+		CHECK(parse({ "202303" }).numBenchmarkIterations_ == 0);
+		CHECK(parse({ "202303", "--benchmark" }).numBenchmarkIterations_ == 100);
+		CHECK(parse({ "202303", "--benchmark=25" }).numBenchmarkIterations_ == 25);
+		CHECK(parse({ "202303", "--benchmark", "--warmup=0" }).numWarmupIterations_ == 0);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--benchmark=0" }), "at least one benchmark iteration expected", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--benchmark=x" }), "invalid value of option '--benchmark': 'x'", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--warmup=-1" }), "invalid value of option '--warmup': '-1'", runtime_error);
+		CHECK(parse({ "202303" }).batch_ == false);
+		CHECK(parse({ "202303", "--batch" }).batchInputPaths_ == vector<string>{ "202303.txt" });
+		CHECK(parse({ "202303", "a.txt", "--batch", "inputs", "@list.txt" }).batchInputPaths_ == vector<string>{ "a.txt", "inputs", "@list.txt" });
+		CHECK(parse({ "202303" }).numThreads_ == 0);
+		CHECK(parse({ "202303", "--threads=3" }).numThreads_ == 3);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--threads=0" }), "at least one thread expected", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--batch", "--benchmark" }), "batch mode cannot be combined with --benchmark", runtime_error);
+		CHECK(parse({ "202303" }).generate_ == false);
+		CHECK(parse({ "202303", "--generate=100" }).inputGeneration_.size_ == 100);
+		CHECK(parse({ "202303", "--generate=100" }).inputGeneration_.seed_ == 0);
+		CHECK(parse({ "202303", "--generate=100" }).generatedInputFilePath_.empty());
+		CHECK(parse({ "202303", "--generate=100", "--seed=7", "big.txt" }).inputGeneration_.seed_ == 7);
+		CHECK(parse({ "202303", "--generate=100", "--seed=7", "big.txt" }).generatedInputFilePath_ == "big.txt");
+
+		const InputGeneration inputGeneration = parse({ "202303", "--generate=1", "--parameter=a=0.25", "--parameter=b=3" }).inputGeneration_;
+
+		CHECK(inputGeneration.parameter("a", 1.0) == 0.25);
+		CHECK(inputGeneration.parameter("b", 1.0) == 3.0);
+		CHECK(inputGeneration.parameter("c", 1.0) == 1.0);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--generate=1", "--parameter=a" }), "invalid parameter: 'a'", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--generate=1", "--parameter=a=x" }), "invalid value of parameter 'a': 'x'", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--generate=1", "--batch" }), "--generate cannot be combined with --batch or --benchmark", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--generate=1", "a.txt", "b.txt" }), "unexpected argument: 'b.txt'", runtime_error);
+		CHECK(parse({ "202303" }).maxScalingSize_ == 0);
+		CHECK(parse({ "202303", "--scaling=100:1600" }).minScalingSize_ == 100);
+		CHECK(parse({ "202303", "--scaling=100:1600" }).maxScalingSize_ == 1600);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--scaling=100" }), "invalid value of option '--scaling': '100'", runtime_error);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--scaling=100:150" }), "--scaling needs a positive minimum size and a maximum size of at least twice the minimum", runtime_error);
+		CHECK(parse({ "202303", "--save-baseline=a.baseline" }).saveBaselineFilePath_ == "a.baseline");
+		CHECK(parse({ "202303", "--save-baseline=a.baseline" }).numBenchmarkIterations_ == 100);
+		CHECK(parse({ "202303", "--benchmark=20", "--compare-baseline=a.baseline" }).compareBaselineFilePath_ == "a.baseline");
+		CHECK(parse({ "202303", "--benchmark=20", "--compare-baseline=a.baseline" }).numBenchmarkIterations_ == 20);
+		CHECK(parse({ "202303" }).regressionThreshold_ == 0.1);
+		CHECK(parse({ "202303" }).traceFilePath_.empty());
+		CHECK(parse({ "202303", "--trace=trace.json" }).traceFilePath_ == "trace.json");
+		CHECK(parse({ "202303", "--regression-threshold=0.25" }).regressionThreshold_ == 0.25);
+		CHECK_THROWS_WITH_AS(parse({ "202303", "--regression-threshold=-1" }), "invalid value of option '--regression-threshold': '-1'", runtime_error);
+	}
+
+	class ThreadRecorder : public PuzzleSolution
+	{
+	public:
+		explicit ThreadRecorder(AnswerEvaluation answerEvaluation) : PuzzleSolution(InputLoading::Buffered, answerEvaluation) {}
+
+	public:
+		thread::id answer1ThreadId_;
+		thread::id answer2ThreadId_;
+
+	private:
+		int answer1() override { answer1ThreadId_ = this_thread::get_id(); return 1; }
+		int answer2() override { answer2ThreadId_ = this_thread::get_id(); return 2; }
+	};
+
+	TEST_CASE("PuzzleSolution answer evaluation")
+	{
+		const string filePath = (filesystem::temp_directory_path() / "aoc-test-answer-evaluation.txt").string();
+
+		{
+			ofstream fileStream{filePath, ios::binary | ios::trunc};
+		}
+
+		ThreadRecorder sequentialSolution{AnswerEvaluation::Sequential};
+
+		CHECK(sequentialSolution.run(filePath) == EXIT_SUCCESS);
+		CHECK(sequentialSolution.answer1ThreadId_ == this_thread::get_id());
+		CHECK(sequentialSolution.answer2ThreadId_ == this_thread::get_id());
+
+		ThreadRecorder concurrentSolution{AnswerEvaluation::Concurrent};
+
+		CHECK(concurrentSolution.run(filePath) == EXIT_SUCCESS);
+		CHECK(concurrentSolution.answer1ThreadId_ == this_thread::get_id());
+		CHECK(concurrentSolution.answer2ThreadId_ != this_thread::get_id());
+
+		filesystem::remove(filePath);
+	}
+
+	TEST_CASE("StreamingPuzzleSolution")
+	{
+		const string filePath = (filesystem::temp_directory_path() / "aoc-test-streamed-input.txt").string();
+
+		for(const char* text : { "", "\n", "abc", "abc\n", "abc\n\ndef", "467..114..\n...*......\n..35..633.\n" })
+		{
+			{
+				ofstream fileStream{filePath, ios::binary | ios::trunc};
+				fileStream << text;
+			}
+
+			for(size_t chunkSize : { 1, 2, 3, 5, 64 })
+			{
+				CHECK(LineRecorder(chunkSize).record(filePath) == loadPuzzleInput(filePath));
+				CHECK(LineRecorder(chunkSize).recordText(text) == loadPuzzleInput(filePath));
+			}
+		}
+
+		filesystem::remove(filePath);
+
+		CHECK_THROWS_WITH_AS(LineRecorder(64).record(filePath),
+		                     format("unable to open input file: \"{}\"", filePath).c_str(),
+		                     runtime_error);
+	}
+
+	class LineCounter : public PuzzleSolution
+	{
+	private:
+		int answer1() override { return static_cast<int>(input().size()); }
+		int answer2() override { return static_cast<int>(input().text().size()); }
+	};
+
+	AOC_REGISTER_PUZZLE_SOLUTION(LineCounter, "000002");
+
+	TEST_CASE("PuzzleSolution::solveText")
+	{
+		LineCounter lineCounter;
+
+		CHECK(lineCounter.solveText("") == array<int, 2>{ 0, 0 });
+		CHECK(lineCounter.solveText("abc\ndef\n") == array<int, 2>{ 2, 8 });
+		CHECK(lineCounter.solveText("a") == array<int, 2>{ 1, 1 });
+	}
+
+	static const PuzzleSolutionRegistration registrationOfEarlierLineCounter{
+		"000001",
+		typeid(ThreadRecorder),
+		[]() -> unique_ptr<PuzzleSolution> { return make_unique<LineCounter>(); }};
+
+	TEST_CASE("registeredPuzzleSolutions")
+	{
+		REQUIRE(registeredPuzzleSolutions().size() == 2);
+		CHECK(registeredPuzzleSolutions()[0].puzzleId_ == "000001");
+		CHECK(registeredPuzzleSolutions()[1].puzzleId_ == "000002");
+		CHECK(findRegisteredPuzzleSolution("000002") == &registeredPuzzleSolutions()[1]);
+		CHECK(findRegisteredPuzzleSolution("000003") == nullptr);
+		CHECK(findRegisteredPuzzleSolution(typeid(LineCounter)) == &registeredPuzzleSolutions()[1]);
+		CHECK(findRegisteredPuzzleSolution(typeid(LineRecorder)) == nullptr);
+
+		CHECK_THROWS_WITH_AS(PuzzleSolutionRegistration("000001", typeid(LineCounter), registeredPuzzleSolutions()[0].createPuzzleSolution_),
+		                     "puzzle solution registered more than once: '000001'",
+		                     runtime_error);
+	}
+
+	TEST_CASE("solvePuzzles")
+	{
+		const string filePath1 = (filesystem::temp_directory_path() / "aoc-test-solve-puzzles-1.txt").string();
+		const string filePath2 = (filesystem::temp_directory_path() / "aoc-test-solve-puzzles-2.txt").string();
+
+		{
+			ofstream fileStream1{filePath1, ios::binary | ios::trunc};
+			fileStream1 << "abc\ndef\n";
+
+			ofstream fileStream2{filePath2, ios::binary | ios::trunc};
+			fileStream2 << "a";
+		}
+
+		vector<PuzzleRun> puzzleRuns;
+
+		for(int i=0; i<10; ++i)
+			puzzleRuns.push_back({ findRegisteredPuzzleSolution((i % 3 == 0) ? "000001" : "000002"),
+			                       (i % 2 == 0) ? filePath1 : filePath2 });
+
+		for(unsigned numThreads : { 1, 3, 16 })
+		{
+			const vector<PuzzleRunResult> results = solvePuzzles(puzzleRuns, numThreads);
+
+			REQUIRE(results.size() == puzzleRuns.size());
+
+			for(int i=0; i<10; ++i)
+			{
+				CHECK(results[i].puzzleId_ == ((i % 3 == 0) ? "000001" : "000002"));
+				CHECK(results[i].answers_ == ((i % 2 == 0) ? array<int, 2>{ 2, 8 } : array<int, 2>{ 1, 1 }));
+				CHECK(results[i].error_.empty());
+			}
+		}
+
+		// A failing puzzle leaves the others alone.
+		const string missingFilePath = (filesystem::temp_directory_path() / "aoc-test-solve-puzzles-missing.txt").string();
+
+		puzzleRuns.insert(puzzleRuns.begin() + 5, { findRegisteredPuzzleSolution("000002"), missingFilePath });
+
+		for(unsigned numThreads : { 1, 3 })
+		{
+			const vector<PuzzleRunResult> results = solvePuzzles(puzzleRuns, numThreads);
+
+			REQUIRE(results.size() == puzzleRuns.size());
+
+			for(size_t i=0; i<results.size(); ++i)
+			{
+				CAPTURE(i);
+
+				if(i == 5)
+				{
+					CHECK(results[i].error_ == format("unable to open input file: \"{}\"", missingFilePath));
+					CHECK(results[i].answers_ == array<int, 2>{});
+				}
+				else
+				{
+					CHECK(results[i].error_.empty());
+					CHECK(results[i].answers_ == (((i < 5 ? i : i - 1) % 2 == 0) ? array<int, 2>{ 2, 8 } : array<int, 2>{ 1, 1 }));
+				}
+			}
+		}
+
+		CHECK(solvePuzzles({}, 4).empty());
+
+		filesystem::remove(filePath1);
+		filesystem::remove(filePath2);
+	}
+
+#if !defined(_WIN32)
+	TEST_CASE("servePuzzleSolutions")
+	{
+		const string socketPath = (filesystem::temp_directory_path() / "aoc-test-server.sock").string();
+		const string filePath = (filesystem::temp_directory_path() / "aoc-test-server-input.txt").string();
+
+		{
+			ofstream fileStream{filePath, ios::binary | ios::trunc};
+			fileStream << "abc\ndef\n";
+		}
+
+		thread serverThread{[&] { servePuzzleSolutions(socketPath, 2); }};
+
+		const auto connect = [&]
+		{
+			sockaddr_un address{};
+
+			address.sun_family = AF_UNIX;
+			socketPath.copy(address.sun_path, socketPath.size());
+
+			const int socketDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+
+			while(::connect(socketDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1)
+				this_thread::sleep_for(chrono::milliseconds(1));
+
+			return socketDescriptor;
+		};
+
+		const auto request = [](int socketDescriptor, std::string_view request)
+		{
+			SocketStream socketStream{socketDescriptor};
+			string response;
+
+			socketStream.write(request);
+			socketStream.readLine(response);
+
+			return response;
+		};
+
+		const int socketDescriptor1 = connect();
+		const int socketDescriptor2 = connect();
+
+		CHECK(request(socketDescriptor1, format("solve 000001 {}\n", filePath)) == "ok 2 8");
+		CHECK(request(socketDescriptor2, "solve-inline 000002 5\na\nbc\n") == "ok 2 5");
+		CHECK(request(socketDescriptor1, "solve-inline 000002 1\nx") == "ok 1 1");
+		CHECK(request(socketDescriptor1, format("solve 000002 {}\n", filePath)) == "ok 2 8");
+		CHECK(request(socketDescriptor1, "solve 000003 input.txt\n") == "error unknown puzzle: '000003'");
+		CHECK(request(socketDescriptor1, "solve 000001 missing.txt\n") == "error unable to open input file: \"missing.txt\"");
+		CHECK(request(socketDescriptor1, "solve-inline 000001 x\n") == "error invalid payload size: 'x'");
+		CHECK(request(socketDescriptor1, "solve\n") == "error invalid request: 'solve'");
+
+		CHECK(request(socketDescriptor1, format("solve 000001 {}\n", filePath)) == "ok 2 8");
+
+		close(socketDescriptor2);
+
+		const int socketDescriptor3 = connect();
+
+		CHECK(request(socketDescriptor3, format("solve-inline 000001 {}\n", maxInlinePayloadSize + 1)) ==
+		      format("error payload too large: {} bytes (at most {})", maxInlinePayloadSize + 1, maxInlinePayloadSize));
+		CHECK(recv(socketDescriptor3, array<char, 1>().data(), 1, 0) == 0);
+
+		close(socketDescriptor3);
+
+		const int socketDescriptor4 = connect();
+
+		CHECK(request(socketDescriptor4, string(maxRequestLineSize + 100000, 'x')).empty());
+
+		close(socketDescriptor4);
+
+		CHECK(request(socketDescriptor1, "shutdown\n") == "ok");
+
+		close(socketDescriptor1);
+		serverThread.join();
+
+		CHECK(!filesystem::exists(socketPath));
+
+		filesystem::remove(filePath);
+	}
+#endif
+
+	TEST_CASE("expandBatchInputPaths and solvePuzzleBatch")
+	{
+		const filesystem::path directoryPath = filesystem::temp_directory_path() / "aoc-test-batch";
+		const string listFilePath = (filesystem::temp_directory_path() / "aoc-test-batch-list.txt").string();
+
+		filesystem::remove_all(directoryPath);
+		filesystem::create_directory(directoryPath);
+		filesystem::create_directory(directoryPath / "nested");
+
+		vector<string> puzzleInputFilePaths;
+
+		for(int i=0; i<20; ++i)
+		{
+			puzzleInputFilePaths.push_back((directoryPath / format("input{:02}.txt", i)).string());
+
+			ofstream fileStream{puzzleInputFilePaths.back(), ios::binary};
+
+			for(int line=0; line<i; ++line)
+				fileStream << string(line, 'x') << '\n';
+		}
+
+		{
+			ofstream fileStream{listFilePath, ios::binary};
+			fileStream << puzzleInputFilePaths[3] << "\n\n" << puzzleInputFilePaths[1] << "\n";
+		}
+
+		CHECK(expandBatchInputPaths({ directoryPath.string() }) == puzzleInputFilePaths);
+		CHECK(expandBatchInputPaths({ "@" + listFilePath, "missing.txt" }) == vector<string>{ puzzleInputFilePaths[3], puzzleInputFilePaths[1], "missing.txt" });
+		CHECK_THROWS_WITH_AS(expandBatchInputPaths({ "@missing.txt" }), "unable to open list file: \"missing.txt\"", runtime_error);
+
+		for(unsigned numThreads : { 1, 4 })
+		{
+			const vector<PuzzleRunResult> results = solvePuzzleBatch(*findRegisteredPuzzleSolution("000002"), puzzleInputFilePaths, numThreads);
+
+			REQUIRE(results.size() == puzzleInputFilePaths.size());
+
+			for(int i=0; i<20; ++i)
+			{
+				CHECK(results[i].answers_ == array<int, 2>{ i, i * (i + 1) / 2 });
+				CHECK(results[i].error_.empty());
+			}
+		}
+
+		vector<string> failingPuzzleInputFilePaths = puzzleInputFilePaths;
+		failingPuzzleInputFilePaths.insert(failingPuzzleInputFilePaths.begin() + 5, "missing.txt");
+
+		const vector<PuzzleRunResult> failingResults = solvePuzzleBatch(*findRegisteredPuzzleSolution("000002"), failingPuzzleInputFilePaths, 2);
+
+		REQUIRE(failingResults.size() == failingPuzzleInputFilePaths.size());
+		CHECK(failingResults[5].error_ == "unable to open input file: \"missing.txt\"");
+		CHECK(failingResults[5].answers_ == array<int, 2>{ 0, 0 });
+		CHECK(failingResults[6].answers_ == array<int, 2>{ 5, 15 });
+		CHECK(failingResults.back().answers_ == array<int, 2>{ 19, 190 });
+
+		filesystem::remove_all(directoryPath);
+		filesystem::remove(listFilePath);
+	}
+}
+
+#endif
+
+#if defined(AOC_BENCHMARK)
+
+namespace aoc
+{
+	// Writes lines of random length (0-120 characters) until the file is
+	// at least fileSize bytes long.
+	static void generateSyntheticInput(const string& filePath,
+	                                   size_t fileSize)
+	{
+		ofstream fileStream{filePath, ios::binary | ios::trunc};
+
+		if(!fileStream.is_open())
+			panic(format("unable to create synthetic input file: \"{}\"", filePath));
+
+		mt19937_64 randomEngine{20231203};
+		uniform_int_distribution<size_t> lineLengthDistribution{0, 120};
+
+		string block;
+		size_t size = 0;
+
+		while(size < fileSize)
+		{
+			block.clear();
+
+			while(block.size() < (1 << 20))
+			{
+				block.append(lineLengthDistribution(randomEngine), 'a' + static_cast<char>(block.size() % 26));
+				block += '\n';
+			}
+
+			fileStream.write(block.data(), block.size());
+			size += block.size();
+		}
+	}
+
+	// Reports the fastest of a few runs, so that the results reflect a warm
+	// page cache rather than whichever run happened to fault the file in.
+	template<class Function>
+	static void benchmark(std::string_view name,
+	                      size_t numBytes,
+	                      Function function)
+	{
+		constexpr int numRuns = 3;
+
+		chrono::duration<double> minDuration = chrono::duration<double>::max();
+		size_t numLines = 0;
+
+		for(int run=0; run<numRuns; ++run)
+		{
+			const auto startTime = chrono::steady_clock::now();
+
+			numLines = function();
+
+			minDuration = min<chrono::duration<double>>(minDuration, chrono::steady_clock::now() - startTime);
+		}
+
+		println("{:<32} {:>10.1f} ms {:>8.2f} GB/s {:>12} lines",
+		        name,
+		        1000.0 * minDuration.count(),
+		        numBytes / minDuration.count() / 1e9,
+		        numLines);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace aoc;
+
+	const size_t fileSize = ((argc > 1) ? stoull(argv[1]) : 1024) << 20;
+	const string filePath = (filesystem::temp_directory_path() / "aoc-benchmark-input.txt").string();
+
+	println("generating {} MiB of synthetic input in \"{}\"", fileSize >> 20, filePath);
+
+	generateSyntheticInput(filePath, fileSize);
+
+	const size_t numBytes = filesystem::file_size(filePath);
+
+	benchmark("loadPuzzleInput", numBytes, [&] { return loadPuzzleInput(filePath).size(); });
+	benchmark("loadBufferedPuzzleInput", numBytes, [&] { return loadBufferedPuzzleInput(filePath).size(); });
+	benchmark("loadMappedPuzzleInput", numBytes, [&] { return loadMappedPuzzleInput(filePath).size(); });
+
+	const MappedFile file{filePath};
+
+	for(int instructionSet=0; instructionSet<=static_cast<int>(detectInstructionSet()); ++instructionSet)
+	{
+		benchmark(format("indexLines ({})", instructionSetName(InstructionSet(instructionSet))),
+		          numBytes,
+		          [&] { return indexLines(file.view(), InstructionSet(instructionSet)).size() - 1; });
+	}
+
+	filesystem::remove(filePath);
+
+	return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined(AOC_RUNNER)
+
+// Solves the given puzzles, or all linked ones, in a single process, or
+// serves them on a Unix domain socket (see servePuzzleSolutions()):
+//
+//   aoc-runner [--threads=count] [--timings] [--trace=file]
+//              [yyyydd[=puzzle-input-file]]...
+//   aoc-runner --serve=socket-path [--threads=count]
+//
+// Puzzles without an explicit input file read yyyydd.txt. Results are
+// printed one puzzle per line in the order of the command line (or of the
+// puzzle identifiers), however the puzzles happened to be scheduled.
+int main(int argc, char* argv[])
+{
+	using namespace aoc;
+
+	unsigned numThreads = numWorkerThreads();
+	bool timings = false;
+	string traceFilePath;
+	string socketPath;
+	vector<PuzzleRun> puzzleRuns;
+
+	for(int argumentIndex=1; argumentIndex<argc; ++argumentIndex)
+	{
+		const std::string_view argument = argv[argumentIndex];
+
+		if(argument.starts_with("--threads="))
+		{
+			numThreads = static_cast<unsigned>(parseCount("--threads", argument.substr(argument.find('=') + 1)));
+
+			if(numThreads == 0)
+				panic("at least one thread expected");
+		}
+		else if(argument == "--timings")
+		{
+			timings = true;
+		}
+		else if(argument.starts_with("--trace="))
+		{
+			traceFilePath = argument.substr(argument.find('=') + 1);
+		}
+		else if(argument.starts_with("--serve="))
+		{
+			socketPath = argument.substr(argument.find('=') + 1);
+		}
+		else if(argument.starts_with("--"))
+		{
+			panic(format("unknown option: '{}'", argument));
+		}
+		else
+		{
+			const size_t separatorPos = argument.find('=');
+			const std::string_view puzzleId = argument.substr(0, separatorPos);
+			const RegisteredPuzzleSolution* puzzleSolution = findRegisteredPuzzleSolution(puzzleId);
+
+			if(!puzzleSolution)
+				panic(format("unknown puzzle: '{}'", puzzleId));
+
+			puzzleRuns.push_back({ puzzleSolution,
+			                       (separatorPos != std::string_view::npos) ? string(argument.substr(separatorPos + 1))
+			                                                                : format("{}.txt", puzzleId) });
+		}
+	}
+
+	if(!traceFilePath.empty())
+		startTracing(traceFilePath);
+
+	if(!socketPath.empty())
+	{
+		if(!puzzleRuns.empty())
+			panic("puzzles cannot be given when serving");
+
+		servePuzzleSolutions(socketPath, numThreads);
+
+		if(!traceFilePath.empty())
+			stopTracing();
+
+		return EXIT_SUCCESS;
+	}
+
+	if(puzzleRuns.empty())
+		for(const RegisteredPuzzleSolution& puzzleSolution : registeredPuzzleSolutions())
+			puzzleRuns.push_back({ &puzzleSolution, format("{}.txt", puzzleSolution.puzzleId_) });
+
+	const auto startTime = chrono::steady_clock::now();
+	const vector<PuzzleRunResult> results = solvePuzzles(puzzleRuns, numThreads);
+	const auto duration = chrono::steady_clock::now() - startTime;
+
+	if(!traceFilePath.empty())
+		stopTracing();
+
+	bool failed = false;
+
+	for(const PuzzleRunResult& result : results)
+	{
+		if(!result.error_.empty())
+		{
+			failed = true;
+
+			println("{} error {}", result.puzzleId_, result.error_);
+
+			continue;
+		}
+
+		if(timings)
+			println("{} {} {} {:>12.3f} ms",
+			        result.puzzleId_,
+			        result.answers_[0],
+			        result.answers_[1],
+			        chrono::duration<double, milli>(result.duration_).count());
+		else
+			println("{} {} {}", result.puzzleId_, result.answers_[0], result.answers_[1]);
+	}
+
+	if(timings)
+		println(stderr, "{} puzzles on {} threads in {:.3f} ms",
+		        results.size(),
+		        numThreads,
+		        chrono::duration<double, milli>(duration).count());
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined(AOC_FUZZ) && !defined(AOC_LIBFUZZER)
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size);
+
+// Drives the LLVMFuzzerTestOneInput() of a solution built with -DAOC_FUZZ
+// where libFuzzer is not available (built with -DAOC_LIBFUZZER, libFuzzer
+// provides its own main()):
+//
+//   yyyydd-fuzz [--runs=count] [--seed=seed] [--max-len=size] [corpus-file]...
+//
+// Without coverage feedback it hunts for slow inputs instead: mutants
+// slower than the input they were derived from join the corpus. An input
+// that crashes with an exception other than a panic is written to
+// crash.txt.
+int main(int argc, char* argv[])
+{
+	using namespace aoc;
+
+	size_t numRuns = 100000;
+	uint64_t seed = 0;
+	size_t maxSize = 4096;
+	vector<string> corpus;
+
+	for(int argumentIndex=1; argumentIndex<argc; ++argumentIndex)
+	{
+		const std::string_view argument = argv[argumentIndex];
+
+		if(argument.starts_with("--runs="))
+		{
+			numRuns = parseCount("--runs", argument.substr(argument.find('=') + 1));
+		}
+		else if(argument.starts_with("--seed="))
+		{
+			seed = parseCount("--seed", argument.substr(argument.find('=') + 1));
+		}
+		else if(argument.starts_with("--max-len="))
+		{
+			maxSize = parseCount("--max-len", argument.substr(argument.find('=') + 1));
+		}
+		else if(argument.starts_with("--"))
+		{
+			panic(format("unknown option: '{}'", argument));
+		}
+		else
+		{
+			ifstream fileStream{string(argument), ios::binary};
+
+			if(!fileStream)
+				panic(format("unable to open corpus file: \"{}\"", argument));
+
+			corpus.emplace_back(istreambuf_iterator<char>(fileStream), istreambuf_iterator<char>());
+
+			if(corpus.back().size() > maxSize)
+				corpus.back().resize(maxSize);
+		}
+	}
+
+	if(corpus.empty())
+		corpus.emplace_back();
+
+	constexpr size_t maxCorpusSize = 1024;
+
+	InputRandom random{seed};
+	vector<chrono::steady_clock::duration> durations;
+
+	const auto runInput = [](const string& input)
+	{
+		const auto startTime = chrono::steady_clock::now();
+
+		try
+		{
+			LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+		}
+		catch(const exception& exception)
+		{
+			ofstream{"crash.txt", ios::binary | ios::trunc} << input;
+
+			println(stderr, "input of {} bytes (written to crash.txt) crashed with: {}", input.size(), exception.what());
+
+			exit(EXIT_FAILURE);
+		}
+
+		return chrono::steady_clock::now() - startTime;
+	};
+
+	for(const string& input : corpus)
+		durations.push_back(runInput(input));
+
+	for(size_t run=0; run<numRuns; ++run)
+	{
+		const size_t parentIndex = random.uniform(0, corpus.size() - 1);
+		string input = corpus[parentIndex];
+		const size_t numMutations = random.uniform(1, 4);
+
+		for(size_t i=0; i<numMutations; ++i)
+			mutateFuzzInput(input, random, maxSize);
+
+		const chrono::steady_clock::duration duration = runInput(input);
+
+		if(duration <= durations[parentIndex])
+			continue;
+
+		if(corpus.size() < maxCorpusSize)
+		{
+			corpus.push_back(std::move(input));
+			durations.push_back(duration);
+		}
+		else
+		{
+			const size_t index = random.uniform(0, corpus.size() - 1);
+
+			corpus[index] = std::move(input);
+			durations[index] = duration;
+		}
+	}
+
+	return EXIT_SUCCESS;
 }
 
 #endif
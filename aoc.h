@@ -1,8 +1,26 @@
 #ifndef AOC_H
 #define AOC_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <cstdint>
+#include <initializer_list>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
 #include <source_location>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
 #include <vector>
 
 #define AOC_FUNCTIONIZE(a, b) \
@@ -35,6 +53,21 @@
 #define AOC_NUM_ELEMENTS(array) \
 	(sizeof(array) / sizeof(*(array)))
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AOC_X86
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AOC_TARGET(instructionSet) \
+	__attribute__((target(instructionSet)))
+#else
+#define AOC_TARGET(instructionSet)
+#endif
+
 namespace aoc
 {
 	template<class T>
@@ -47,31 +80,1090 @@ namespace aoc
 
 	std::vector<std::string> loadPuzzleInput(const std::string& puzzleInputFilePath);
 
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& filePath);
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile(const MappedFile&) = delete;
+		~MappedFile();
+
+	public:
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+	public:
+		const char* data() const { return data_; }
+		std::size_t size() const { return size_; }
+		std::string_view view() const { return std::string_view(data_, size_); }
+
+	private:
+		void unmap();
+
+	private:
+		const char* data_ = nullptr;
+		std::size_t size_ = 0;
+	};
+
+	// Tracing of spans of execution into a file in the Chrome trace event
+	// format, which chrome://tracing and https://ui.perfetto.dev load. It is
+	// off until startTracing(); stopTracing() writes the spans recorded since
+	// and has to be called when no other thread records spans any more. Each
+	// thread records into a buffer of its own without locking.
+	void startTracing(const std::string& traceFilePath);
+	void stopTracing();
+	bool tracingEnabled();
+	void recordTraceSpan(const char* name,
+	                     std::int64_t index,
+	                     std::chrono::steady_clock::time_point startTime,
+	                     std::chrono::steady_clock::time_point endTime);
+
+	// Records the enclosing scope as a span, named by a string which outlives
+	// the trace (e.g. a literal), with an optional index such as that of a
+	// band of rows. Unless tracing, it does not even read the clock.
+	class ScopedTraceSpan
+	{
+	public:
+		explicit ScopedTraceSpan(const char* name,
+		                         std::int64_t index=-1)
+			: name_(tracingEnabled() ? name : nullptr)
+			, index_(index)
+		{
+			if(name_)
+				startTime_ = std::chrono::steady_clock::now();
+		}
+
+		ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+
+		~ScopedTraceSpan()
+		{
+			if(name_)
+				recordTraceSpan(name_, index_, startTime_, std::chrono::steady_clock::now());
+		}
+
+	public:
+		ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+	private:
+		const char* name_;
+		std::int64_t index_;
+		std::chrono::steady_clock::time_point startTime_;
+	};
+
+	// Number of threads the parallel algorithms below may use; defaults to
+	// the number of hardware threads.
+	unsigned numWorkerThreads();
+	void setNumWorkerThreads(unsigned numThreads);
+
+	// Number of tasks worth splitting numBytes of input into: one per worker
+	// thread, but never less than about a megabyte per task.
+	std::size_t numParallelTasks(std::size_t numBytes);
+
+	// Runs function(taskIndex) for every task on its own thread (the first one
+	// on the calling thread) and waits for all of them. An exception thrown by
+	// any task is rethrown afterwards; the lowest task index wins, so errors
+	// are reported as if the tasks had run sequentially.
+	template<class Function>
+	void parallelFor(std::size_t numTasks,
+	                 Function function)
+	{
+		std::vector<std::exception_ptr> exceptions(numTasks);
+		std::vector<std::thread> threads;
+
+		const auto runTask = [&](std::size_t taskIndex)
+		{
+			try
+			{
+				function(taskIndex);
+			}
+			catch(...)
+			{
+				exceptions[taskIndex] = std::current_exception();
+			}
+		};
+
+		for(std::size_t taskIndex=1; taskIndex<numTasks; ++taskIndex)
+			threads.emplace_back(runTask, taskIndex);
+
+		if(numTasks > 0)
+			runTask(0);
+
+		for(auto& thread : threads)
+			thread.join();
+
+		for(const auto& exception : exceptions)
+			if(exception)
+				std::rethrow_exception(exception);
+	}
+
+	// Splits text into numRanges consecutive ranges of roughly equal size,
+	// each of which ends just past a newline or at the end of text. Ranges
+	// may be empty when lines are longer than the requested range size.
+	std::vector<std::string_view> splitIntoLineAlignedRanges(std::string_view text,
+	                                                         std::size_t numRanges);
+
+	enum class InstructionSet
+	{
+		Scalar,
+		Sse2,
+		Avx2
+	};
+
+	// Returns the widest instruction set supported by the CPU at runtime.
+	InstructionSet detectInstructionSet();
+	std::string_view instructionSetName(InstructionSet instructionSet);
+
+	// Builds the line offset table used by LineArena. Entry i is the offset of
+	// the first character of line i and the last entry is one past the end of
+	// the last line's terminating newline, whether or not the text actually
+	// ends with one. Lines are split the same way std::getline splits them.
+	// Newlines are located with the widest instruction set available unless
+	// one is given explicitly, and large texts are indexed in parallel.
+	std::vector<std::size_t> indexLines(std::string_view text);
+	std::vector<std::size_t> indexLines(std::string_view text,
+	                                    InstructionSet instructionSet);
+	std::vector<std::size_t> indexLinesInParallel(std::string_view text,
+	                                              std::size_t numTasks);
+
+	// Lines stored back to back in a single buffer (owned or memory mapped)
+	// and addressed through a packed table of line offsets.
+	class LineArena
+	{
+	public:
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = std::string_view;
+
+		public:
+			Iterator() = default;
+			Iterator(const LineArena* lineArena,
+			         std::size_t index)
+				: lineArena_(lineArena)
+				, index_(index)
+			{
+			}
+
+		public:
+			std::string_view operator*() const { return (*lineArena_)[index_]; }
+			Iterator& operator++() { ++index_; return *this; }
+			Iterator operator++(int) { Iterator result{*this}; ++index_; return result; }
+			bool operator==(const Iterator& other) const { return index_ == other.index_; }
+
+		private:
+			const LineArena* lineArena_ = nullptr;
+			std::size_t index_ = 0;
+		};
+
+	public:
+		LineArena() : lineOffsets_(1, 0) {}
+		explicit LineArena(std::string text);
+		explicit LineArena(MappedFile file);
+		LineArena(std::initializer_list<std::string_view> lines);
+
+	public:
+		std::size_t size() const { return lineOffsets_.size() - 1; }
+		bool empty() const { return size() == 0; }
+		std::string_view operator[](std::size_t index) const;
+		Iterator begin() const { return Iterator{this, 0}; }
+		Iterator end() const { return Iterator{this, size()}; }
+		std::string_view text() const;
+		std::size_t findFirstLineAtOrAfter(std::size_t pos) const;
+
+		// Leaves the arena empty and hands over its buffer (empty for mapped
+		// input), so that loading the next input can reuse its capacity.
+		std::string releaseBuffer();
+
+	private:
+		std::string buffer_;
+		MappedFile file_;
+		std::vector<std::size_t> lineOffsets_;
+	};
+
+	LineArena loadBufferedPuzzleInput(const std::string& puzzleInputFilePath);
+	LineArena loadBufferedPuzzleInput(const std::string& puzzleInputFilePath,
+	                                  std::string buffer);
+	LineArena loadMappedPuzzleInput(const std::string& puzzleInputFilePath);
+
+	// Reads a file on a background thread into a ring of numChunks buffers of
+	// chunkSize bytes each (or just the size of the file, if it is smaller),
+	// so that reading the next chunk overlaps with processing the current one. Filled buffers are handed to the consumer
+	// through a lock-free single-producer/single-consumer queue.
+	class ChunkReader
+	{
+	public:
+		static constexpr std::size_t defaultNumChunks = 2;
+
+	public:
+		ChunkReader(const std::string& filePath,
+		            std::size_t chunkSize,
+		            std::size_t numChunks=defaultNumChunks);
+		ChunkReader(const ChunkReader&) = delete;
+		~ChunkReader();
+
+	public:
+		ChunkReader& operator=(const ChunkReader&) = delete;
+
+	public:
+		// Returns the next chunk of the file, or an empty view at its end. The
+		// chunk stays valid until the next call.
+		std::string_view nextChunk();
+
+	private:
+		void readChunks();
+
+	private:
+		class Chunk
+		{
+		public:
+			std::vector<char> data_;
+			std::size_t size_ = 0;
+			bool readFailed_ = false;
+		};
+
+	private:
+		std::string filePath_;
+		int fileDescriptor_;
+		std::vector<Chunk> chunks_;
+		std::atomic<std::size_t> numReadChunks_{0};
+		std::atomic<std::size_t> numReleasedChunks_{0};
+		std::atomic<bool> stopped_{false};
+		bool chunkAcquired_ = false;
+		bool endOfFileReached_ = false;
+		std::thread thread_;
+	};
+
+	// Returns parseLine(line) for every line, in order. The lines are divided
+	// into numTasks bands of roughly equal byte size which are parsed in
+	// parallel.
+	template<class ParseLine>
+	auto parseLines(const LineArena& lines,
+	                ParseLine parseLine,
+	                std::size_t numTasks)
+	{
+		using Result = std::invoke_result_t<ParseLine&, std::string_view>;
+
+		std::vector<std::vector<Result>> bandResults(numTasks);
+
+		parallelFor(numTasks, [&](std::size_t taskIndex)
+		{
+			ScopedTraceSpan bandSpan{"parse band", static_cast<std::int64_t>(taskIndex)};
+
+			const std::size_t bandStart = lines.findFirstLineAtOrAfter(lines.text().size() * taskIndex / numTasks);
+			const std::size_t bandEnd = lines.findFirstLineAtOrAfter(lines.text().size() * (taskIndex + 1) / numTasks);
+
+			bandResults[taskIndex].reserve(bandEnd - bandStart);
+
+			for(std::size_t index=bandStart; index<bandEnd; ++index)
+				bandResults[taskIndex].push_back(parseLine(lines[index]));
+		});
+
+		std::vector<Result> results;
+
+		results.reserve(lines.size());
+
+		for(auto& bandResult : bandResults)
+			for(auto& result : bandResult)
+				results.push_back(std::move(result));
+
+		return results;
+	}
+
+	template<class ParseLine>
+	auto parseLines(const LineArena& lines,
+	                ParseLine parseLine)
+	{
+		return parseLines(lines, parseLine, numParallelTasks(lines.text().size()));
+	}
+
 	[[noreturn]]
 	void panic(const std::string& message,
 	           const std::source_location sourceLocation=std::source_location::current());
 
+	// Makes panic() throw std::runtime_error, as it always does in test
+	// builds, instead of terminating the process, so that a long-running
+	// process survives a request with invalid input.
+	void setPanicThrows(bool panicThrows);
+
+	// Answers are ints, while solutions may well add up more than fits one
+	// on large inputs; they count in 64 bits and panic on an answer which
+	// does not fit, rather than wrapping around.
+	int checkedAnswer(std::int64_t answer);
+
+	enum class InputLoading
+	{
+		Buffered,
+		MemoryMapped
+	};
+
+	enum class Phase
+	{
+		Load,
+		Parse,
+		Answer1,
+		Answer2,
+		Total
+	};
+
+	constexpr std::size_t numPhases = 5;
+
+	std::string_view phaseName(Phase phase);
+
+	enum class CounterEvent
+	{
+		Cycles,
+		Instructions,
+		CacheReferences,
+		CacheMisses,
+		Branches,
+		BranchMisses
+	};
+
+	constexpr std::size_t numCounterEvents = 6;
+
+	std::string_view counterEventName(CounterEvent counterEvent);
+
+	// Values of the hardware performance counters; counters which are not
+	// available are NaN.
+	using CounterValues = std::array<double, numCounterEvents>;
+
+	// Reads the hardware performance counters of the calling thread. They are
+	// opened through perf_event_open() on Linux the first time a thread reads
+	// them; counters the system does not provide (e.g. no PMU inside a virtual
+	// machine, a restrictive perf_event_paranoid or a different platform) read
+	// as NaN, and performanceCountersUnavailabilityReason() explains why.
+	CounterValues readPerformanceCounters();
+	std::string performanceCountersUnavailabilityReason();
+
+	class AllocationStatistics
+	{
+	public:
+		std::size_t numAllocations_ = 0;
+		std::size_t numAllocatedBytes_ = 0;
+		std::size_t peakLiveBytes_ = 0;
+	};
+
+	// Allocations are only tracked when aoc.cpp is compiled with
+	// AOC_TRACK_ALLOCATIONS, which replaces the global operator new and
+	// delete with counting versions; otherwise all statistics read as zero.
+	bool allocationTrackingEnabled();
+
+	// Process-wide number of allocations and allocated bytes since startup,
+	// and the high-water mark of live bytes since the last call to
+	// resetPeakLiveBytes().
+	AllocationStatistics readAllocationStatistics();
+
+	// Starts a new high-water mark at the current number of live bytes and
+	// returns the previous one, which restorePeakLiveBytes() folds back in
+	// so that enclosing scopes still see their own peak.
+	std::size_t resetPeakLiveBytes();
+	void restorePeakLiveBytes(std::size_t peakLiveBytes);
+
+	// Wall-clock durations, and optionally hardware performance counters and
+	// allocation statistics, of the phases of PuzzleSolution::run(). Load is
+	// the time spent obtaining the input bytes, parse the rest of
+	// processInput(). The peak live bytes of a phase are process-wide and
+	// include any nested phase. Solutions which compute their answers while
+	// the input is parsed (see StreamingPuzzleSolution) do all their work in
+	// parse; the reports point that out, as answer1 and answer2 then merely
+	// return stored results. Answers evaluated concurrently would mix their
+	// allocations (and reset each other's peak), so those are not tracked
+	// for the answer phases and read as n/a; total still includes them.
+	class PhaseTimings
+	{
+	public:
+		using Duration = std::chrono::steady_clock::duration;
+
+	public:
+		bool enabled() const { return enabled_; }
+		void setEnabled(bool enabled) { enabled_ = enabled; }
+		bool countersEnabled() const { return countersEnabled_; }
+		void setCountersEnabled(bool countersEnabled) { countersEnabled_ = countersEnabled; }
+		bool allocationsEnabled() const { return allocationsEnabled_; }
+		void setAllocationsEnabled(bool allocationsEnabled) { allocationsEnabled_ = allocationsEnabled; }
+		bool answersInParsePhase() const { return answersInParsePhase_; }
+		void setAnswersInParsePhase(bool answersInParsePhase) { answersInParsePhase_ = answersInParsePhase; }
+		bool concurrentAnswers() const { return concurrentAnswers_; }
+		void setConcurrentAnswers(bool concurrentAnswers) { concurrentAnswers_ = concurrentAnswers; }
+		bool allocationsTracked(Phase phase) const;
+		Duration duration(Phase phase) const { return durations_[static_cast<std::size_t>(phase)]; }
+		const CounterValues& counters(Phase phase) const { return counters_[static_cast<std::size_t>(phase)]; }
+		const AllocationStatistics& allocations(Phase phase) const { return allocations_[static_cast<std::size_t>(phase)]; }
+		void add(Phase phase, Duration duration) { durations_[static_cast<std::size_t>(phase)] += duration; }
+		void addCounters(Phase phase, const CounterValues& counters);
+		void addAllocations(Phase phase, const AllocationStatistics& allocations);
+		void excludeNestedPhase(Phase phase, Phase nestedPhase);
+		void reset();
+
+	public:
+		std::string toString() const;
+		std::string toJson() const;
+
+	private:
+		bool enabled_ = false;
+		bool countersEnabled_ = false;
+		bool allocationsEnabled_ = false;
+		bool answersInParsePhase_ = false;
+		bool concurrentAnswers_ = false;
+		std::array<Duration, numPhases> durations_ = {};
+		std::array<CounterValues, numPhases> counters_ = {};
+		std::array<AllocationStatistics, numPhases> allocations_ = {};
+	};
+
+	// Adds the time spent in the enclosing scope (and the counted events and
+	// allocations, if requested) to a phase, if timings are enabled;
+	// otherwise it does not even read the clock. The scope is traced as a
+	// span named after the phase, too.
+	class ScopedPhaseTimer
+	{
+	public:
+		ScopedPhaseTimer(PhaseTimings& phaseTimings,
+		                 Phase phase)
+			: phaseTimings_(phaseTimings)
+			, phase_(phase)
+			, traceSpan_(phaseName(phase).data())
+		{
+			if(phaseTimings_.enabled())
+			{
+				if(phaseTimings_.allocationsTracked(phase_))
+				{
+					startAllocations_ = readAllocationStatistics();
+					outerPeakLiveBytes_ = resetPeakLiveBytes();
+				}
+
+				if(phaseTimings_.countersEnabled())
+					startCounters_ = readPerformanceCounters();
+
+				startTime_ = std::chrono::steady_clock::now();
+			}
+		}
+
+		ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+
+		~ScopedPhaseTimer()
+		{
+			if(phaseTimings_.enabled())
+			{
+				phaseTimings_.add(phase_, std::chrono::steady_clock::now() - startTime_);
+
+				if(phaseTimings_.countersEnabled())
+				{
+					CounterValues counters = readPerformanceCounters();
+
+					for(std::size_t counterEvent=0; counterEvent<numCounterEvents; ++counterEvent)
+						counters[counterEvent] -= startCounters_[counterEvent];
+
+					phaseTimings_.addCounters(phase_, counters);
+				}
+
+				if(phaseTimings_.allocationsTracked(phase_))
+				{
+					const AllocationStatistics allocations = readAllocationStatistics();
+
+					phaseTimings_.addAllocations(phase_, { allocations.numAllocations_ - startAllocations_.numAllocations_,
+					                                       allocations.numAllocatedBytes_ - startAllocations_.numAllocatedBytes_,
+					                                       allocations.peakLiveBytes_ });
+					restorePeakLiveBytes(outerPeakLiveBytes_);
+				}
+			}
+		}
+
+	public:
+		ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+	private:
+		PhaseTimings& phaseTimings_;
+		Phase phase_;
+		ScopedTraceSpan traceSpan_;
+		std::chrono::steady_clock::time_point startTime_;
+		CounterValues startCounters_;
+		AllocationStatistics startAllocations_;
+		std::size_t outerPeakLiveBytes_ = 0;
+	};
+
+	// Keeps the compiler from optimising away the computation of value, e.g.
+	// answers which a benchmark computes but never prints.
+	template<class T>
+	inline void doNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		const volatile void* volatile valueAddress = &value;
+		static_cast<void>(valueAddress);
+		_ReadWriteBarrier();
+#endif
+	}
+
+	class SampleStatistics
+	{
+	public:
+		double min_ = 0.0;
+		double median_ = 0.0;
+		double mean_ = 0.0;
+		double p99_ = 0.0;
+		double standardDeviation_ = 0.0;
+	};
+
+	// Percentiles use the nearest-rank method; the standard deviation is the
+	// sample standard deviation.
+	SampleStatistics computeSampleStatistics(std::vector<double> samples);
+
+	// One-sided p-value of the Mann-Whitney U test for samples tending to be
+	// larger than baselineSamples, using the normal approximation with tie
+	// and continuity corrections (sound for the tens of samples benchmarks
+	// collect).
+	double mannWhitneyPValue(const std::vector<double>& baselineSamples,
+	                         const std::vector<double>& samples);
+
+	// Benchmark durations in milliseconds, per phase.
+	using BenchmarkSamples = std::array<std::vector<double>, numPhases>;
+
+	// Baselines are text files with a line of samples per phase, headed by
+	// the phase name; lines starting with '#' are comments.
+	void saveBenchmarkBaseline(const std::string& baselineFilePath,
+	                           const BenchmarkSamples& samples,
+	                           std::string_view comment);
+	BenchmarkSamples loadBenchmarkBaseline(const std::string& baselineFilePath);
+
+	class PhaseComparison
+	{
+	public:
+		static constexpr double significanceLevel = 0.01;
+		static constexpr double minDifferenceMs = 0.001;
+
+	public:
+		double baselineMedian_ = 0.0;
+		double median_ = 0.0;
+		double pValue_ = 1.0;
+		bool regression_ = false;
+	};
+
+	// A phase regresses when it is significantly slower than the baseline
+	// (p below significanceLevel) and its median grew by more than
+	// regressionThreshold (a fraction) and by more than minDifferenceMs, so
+	// that sub-microsecond phases do not fail on noise.
+	std::array<PhaseComparison, numPhases> compareWithBaseline(const BenchmarkSamples& baselineSamples,
+	                                                           const BenchmarkSamples& samples,
+	                                                           double regressionThreshold);
+
+	// Random numbers for input generators. Unlike the distributions of
+	// <random>, whose algorithms are unspecified, the mapping from the raw
+	// mt19937_64 sequence is fixed, so that a seed yields the same input
+	// with every standard library.
+	class InputRandom
+	{
+	public:
+		explicit InputRandom(std::uint64_t seed) : engine_(seed) {}
+
+	public:
+		// Uniform in [minValue, maxValue]; the modulo bias is negligible for
+		// the small ranges generators use.
+		std::uint64_t uniform(std::uint64_t minValue,
+		                      std::uint64_t maxValue) { return minValue + engine_() % (maxValue - minValue + 1); }
+		bool chance(double probability) { return static_cast<double>(engine_() >> 11) * 0x1.0p-53 < probability; }
+
+	private:
+		std::mt19937_64 engine_;
+	};
+
+	// What --generate asks a solution to produce. The meaning of size and of
+	// the named parameters is up to each generator.
+	class InputGeneration
+	{
+	public:
+		std::size_t size_ = 0;
+		std::uint64_t seed_ = 0;
+		std::vector<std::pair<std::string, double>> parameters_;
+
+	public:
+		double parameter(std::string_view name,
+		                 double defaultValue) const;
+	};
+
+	// Collects generated input into large blocks before writing them, so
+	// that generators may produce gigabytes one character at a time.
+	class GeneratedInputWriter
+	{
+	public:
+		explicit GeneratedInputWriter(std::ostream& stream) : stream_(stream) {}
+		GeneratedInputWriter(const GeneratedInputWriter&) = delete;
+		~GeneratedInputWriter() { flush(); }
+
+	public:
+		GeneratedInputWriter& operator=(const GeneratedInputWriter&) = delete;
+
+	public:
+		void put(char character)
+		{
+			block_ += character;
+
+			if(block_.size() >= blockSize)
+				flush();
+		}
+
+		void append(std::string_view text)
+		{
+			block_ += text;
+
+			if(block_.size() >= blockSize)
+				flush();
+		}
+
+		void flush();
+
+	private:
+		static constexpr std::size_t blockSize = 1 << 20;
+
+	private:
+		std::ostream& stream_;
+		std::string block_;
+	};
+
+	// A kernel under differential test, with its result rendered as text so
+	// that kernels of any result type share findKernelDivergence().
+	using KernelOutcome = std::function<std::string(std::string_view)>;
+
+	template<class Kernel>
+	KernelOutcome kernelOutcome(Kernel kernel)
+	{
+		return [kernel](std::string_view input) { return std::to_string(kernel(input)); };
+	}
+
+	class KernelVariant
+	{
+	public:
+		std::string name_;
+		KernelOutcome outcome_;
+	};
+
+	// Turns what a generator writes for an InputGeneration into kernel inputs,
+	// e.g. a whole document or each of its lines.
+	using KernelInputGenerator = std::function<std::vector<std::string>(const InputGeneration&)>;
+
+	class KernelDivergence
+	{
+	public:
+		std::string variantName_;
+		InputGeneration inputGeneration_;
+		std::string input_;
+		std::string expected_;
+		std::string actual_;
+
+	public:
+		std::string toString() const;
+	};
+
+	// Runs a reference kernel and its optimised variants on the inputs
+	// generated for every size (smallest first) and seeds 0 to numSeeds - 1,
+	// and returns the first input on which a variant disagrees with the
+	// reference, either in its result or in the message it panics with.
+	std::optional<KernelDivergence> findKernelDivergence(const KernelInputGenerator& generateInputs,
+	                                                     const KernelOutcome& reference,
+	                                                     const std::vector<KernelVariant>& variants,
+	                                                     const std::vector<std::size_t>& sizes,
+	                                                     std::uint64_t numSeeds);
+
+	// Directory where fuzz targets keep their slowest inputs: the value of the
+	// AOC_FUZZ_SLOWEST_DIR environment variable, or the current directory.
+	std::string fuzzSlowestInputsDirectory();
+
+	// A function exercised by a libFuzzer entry point (LLVMFuzzerTestOneInput).
+	// Crashes are left to the fuzzer, but besides that each input is timed
+	// and the slowest ones are kept, both in memory and in the files
+	// <name>-slowest-<rank>.txt, so that pathological inputs can be turned
+	// into benchmark cases. Inputs rejected with a panic count as well.
+	class FuzzTarget
+	{
+	public:
+		using Duration = std::chrono::steady_clock::duration;
+
+		class SlowInput
+		{
+		public:
+			std::string input_;
+			Duration duration_ = {};
+		};
+
+	public:
+		explicit FuzzTarget(std::string name,
+		                    std::string slowestInputsDirectory=fuzzSlowestInputsDirectory(),
+		                    std::size_t numSlowestInputs=8);
+		FuzzTarget(const FuzzTarget&) = delete;
+		~FuzzTarget();
+
+	public:
+		FuzzTarget& operator=(const FuzzTarget&) = delete;
+
+	public:
+		template<class Function>
+		void run(std::string_view input,
+		         Function function);
+		std::size_t numRuns() const { return numRuns_; }
+		const std::vector<SlowInput>& slowestInputs() const { return slowestInputs_; }
+
+	private:
+		bool slowEnough(Duration duration) const;
+		void record(std::string_view input,
+		            Duration duration);
+
+	private:
+		static constexpr std::size_t numRemeasurements = 3;
+
+	private:
+		std::string name_;
+		std::string slowestInputsDirectory_;
+		std::size_t numSlowestInputs_;
+		std::size_t numRuns_ = 0;
+		Duration totalDuration_ = {};
+		std::vector<SlowInput> slowestInputs_;
+	};
+
+	template<class Function>
+	void FuzzTarget::run(std::string_view input,
+	                     Function function)
+	{
+		const auto measure = [&]
+		{
+			const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+			try
+			{
+				doNotOptimize(function(input));
+			}
+			catch(const std::runtime_error&)
+			{
+				// A panic rejecting the input.
+			}
+
+			return std::chrono::steady_clock::now() - startTime;
+		};
+
+		Duration duration = measure();
+
+		++numRuns_;
+		totalDuration_ += duration;
+
+		if(!slowEnough(duration))
+			return;
+
+		// The best of a few more runs, so that an interrupt or cold caches do
+		// not make an ordinary input look slow.
+		for(std::size_t i=0; i<numRemeasurements; ++i)
+		{
+			const Duration remeasuredDuration = measure();
+
+			if(remeasuredDuration < duration)
+				duration = remeasuredDuration;
+		}
+
+		if(slowEnough(duration))
+			record(input, duration);
+	}
+
+	// Applies a random mutation to a fuzz input (flipping, inserting or
+	// erasing a byte, or repeating a slice, which quickly builds the long
+	// runs pathological inputs tend to consist of), keeping it at most
+	// maxSize bytes long.
+	void mutateFuzzInput(std::string& input,
+	                     InputRandom& random,
+	                     std::size_t maxSize);
+
+	enum class ComplexityModel
+	{
+		Linear,
+		Linearithmic,
+		Quadratic
+	};
+
+	std::string_view complexityModelName(ComplexityModel complexityModel);
+
+	// How durations grow with the input size: the model c * f(n) fitting
+	// them best (by relative error), and the exponent of the power law
+	// fitted in log-log space, which also exposes growth between the models
+	// (e.g. n^1.5).
+	class ComplexityFit
+	{
+	public:
+		static constexpr double maxLinearExponent = 1.3;
+
+	public:
+		ComplexityModel model_ = ComplexityModel::Linear;
+		double exponent_ = 1.0;
+
+	public:
+		bool superLinear() const { return (model_ == ComplexityModel::Quadratic) || (exponent_ > maxLinearExponent); }
+	};
+
+	// Needs at least two distinct sizes and positive durations.
+	ComplexityFit fitComplexity(const std::vector<double>& sizes,
+	                            const std::vector<double>& durations);
+
+	enum class TimingsReport
+	{
+		None,
+		Text,
+		Json
+	};
+
+	class RunOptions
+	{
+	public:
+		std::string puzzleInputFilePath_;
+		TimingsReport timingsReport_ = TimingsReport::None;
+		bool performanceCounters_ = false;
+		std::size_t numBenchmarkIterations_ = 0;
+		std::size_t numWarmupIterations_ = 10;
+		bool batch_ = false;
+		std::vector<std::string> batchInputPaths_;
+		unsigned numThreads_ = 0;
+		bool generate_ = false;
+		InputGeneration inputGeneration_;
+		std::string generatedInputFilePath_;
+		std::size_t minScalingSize_ = 0;
+		std::size_t maxScalingSize_ = 0;
+		std::string saveBaselineFilePath_;
+		std::string compareBaselineFilePath_;
+		double regressionThreshold_ = 0.1;
+		std::string traceFilePath_;
+	};
+
+	// Parses the command line of a puzzle solution:
+	//
+	//   yyyydd [--timings[=text|json]] [--counters]
+	//          [--benchmark[=iterations]] [--warmup=iterations]
+	//          [--threads=count] [puzzle-input-file]
+	//   yyyydd --batch [--timings[=text|json]] [--threads=count]
+	//          [puzzle-input-file|directory|@list-file]...
+	//   yyyydd --generate=size [--seed=seed] [--parameter=name=value]...
+	//          [output-file]
+	//   yyyydd --scaling=min-size:max-size [--seed=seed]
+	//          [--parameter=name=value]...
+	//
+	// --save-baseline=file stores the benchmark samples and
+	// --compare-baseline=file [--regression-threshold=fraction] compares
+	// them with stored ones, failing the run on a regression; both imply
+	// --benchmark.
+	//
+	// Generated input goes to the standard output unless a file is given.
+	// --scaling solves generated inputs of doubling sizes and reports how the
+	// duration of each phase grows with the number of input bytes; the run
+	// fails if any phase grows faster than linearly.
+	// The AOC_TIMINGS environment variable (text or json) enables timings
+	// and AOC_COUNTERS (1) performance counters without changing the command
+	// line. Performance counters are reported along with the timings.
+	// --threads limits the number of worker threads (see numWorkerThreads()).
+	// Any of them may be traced with --trace=file (see startTracing()).
+	RunOptions parseRunOptions(int argc,
+	                           char* argv[],
+	                           const std::string& defaultPuzzleInputFilePath);
+
+	// Solutions whose answers only read the processed input may evaluate them
+	// concurrently; the answers are still printed in order.
+	enum class AnswerEvaluation
+	{
+		Sequential,
+		Concurrent
+	};
+
 	class PuzzleSolution
 	{
 	public:
+		explicit PuzzleSolution(InputLoading inputLoading=InputLoading::Buffered,
+		                        AnswerEvaluation answerEvaluation=AnswerEvaluation::Sequential)
+			: inputLoading_(inputLoading)
+			, answerEvaluation_(answerEvaluation)
+		{
+		}
+
 		virtual ~PuzzleSolution() {}
 
 	public:
 		int run(const std::string& puzzleInputFilePath);
+		int run(const RunOptions& runOptions);
+		int run(int argc,
+		        char* argv[],
+		        const std::string& defaultPuzzleInputFilePath);
+
+		// Computes both answers without printing them.
+		std::array<int, 2> solve(const std::string& puzzleInputFilePath);
+		// Same as solve(), for a puzzle input held in memory.
+		std::array<int, 2> solveText(std::string text);
 
 	protected:
-		const std::vector<std::string>& input() const { return input_; }
+		const LineArena& input() const { return input_; }
+		PhaseTimings& phaseTimings() { return phaseTimings_; }
+
+		// Whether processInput() already computes the answers, leaving
+		// answer1() and answer2() to return them.
+		virtual bool answersComputedWhileParsing() const { return false; }
 
 	protected:
+		// May be called more than once (e.g. in benchmark mode) and has to
+		// replace whatever a previous call produced.
 		virtual void processInput(const std::string& puzzleInputFilePath);
+		// Same as processInput(), for a puzzle input held in memory; solutions
+		// which parse their input in processInput() do so here as well.
+		virtual void processText(std::string text);
+
+		// Writes a synthetic puzzle input which depends only on
+		// inputGeneration; solutions without a generator panic.
+		virtual void generateInput(std::ostream& stream,
+		                           const InputGeneration& inputGeneration) const;
 
 	private:
 		virtual int answer1() = 0;
 		virtual int answer2() = 0;
 
 	private:
-		std::vector<std::string> input_;
+		int dispatch(const RunOptions& runOptions);
+		std::array<int, 2> solveInput(const std::function<void()>& processPuzzleInput);
+		int evaluateAnswer(std::size_t answerIndex);
+		int runBenchmark(const RunOptions& runOptions);
+		int runBatch(const RunOptions& runOptions);
+		void runGenerator(const RunOptions& runOptions) const;
+		int runScaling(const RunOptions& runOptions);
+
+	private:
+		InputLoading inputLoading_;
+		AnswerEvaluation answerEvaluation_;
+		LineArena input_;
+		PhaseTimings phaseTimings_;
+	};
+
+	// A solution which consumes its input while it is being read, one chunk
+	// of at most chunkSize bytes at a time, instead of materialising it
+	// through input(). Solutions overriding processChunk() run in constant
+	// memory; the default processChunk() reassembles lines for processLine()
+	// and needs additional memory only for lines spanning several chunks.
+	// All the answer work happens while streaming, so it is timed (and
+	// counted) as the parse phase; the answer phases are trivial.
+	class StreamingPuzzleSolution : public PuzzleSolution
+	{
+	public:
+		static constexpr std::size_t defaultChunkSize = 64 * 1024;
+
+	public:
+		explicit StreamingPuzzleSolution(std::size_t chunkSize=defaultChunkSize)
+			: chunkSize_(chunkSize)
+		{
+		}
+
+	protected:
+		void processInput(const std::string& puzzleInputFilePath) override;
+		// Feeds the text to processChunk() in chunks of chunkSize bytes, just
+		// as if it had been read from a file.
+		void processText(std::string text) override;
+		bool answersComputedWhileParsing() const override { return true; }
+
+	protected:
+		virtual void startInput() {}
+		virtual void processChunk(std::string_view chunk);
+		virtual void processLine(std::string_view /*line*/) {}
+		virtual void finishInput();
+
+	private:
+		std::size_t chunkSize_;
+		std::string partialLine_;
+	};
+
+	using PuzzleSolutionFactory = std::unique_ptr<PuzzleSolution> (*)();
+
+	class RegisteredPuzzleSolution
+	{
+	public:
+		std::string_view puzzleId_;
+		const std::type_info* typeInfo_;
+		PuzzleSolutionFactory createPuzzleSolution_;
 	};
+
+	// Solutions register themselves during static initialisation through
+	// AOC_REGISTER_PUZZLE_SOLUTION, so that a binary linking several of them
+	// (see AOC_RUNNER) can look them up by puzzle identifier (yyyydd).
+	class PuzzleSolutionRegistration
+	{
+	public:
+		PuzzleSolutionRegistration(std::string_view puzzleId,
+		                           const std::type_info& typeInfo,
+		                           PuzzleSolutionFactory createPuzzleSolution);
+	};
+
+	// Sorted by puzzle identifier.
+	const std::vector<RegisteredPuzzleSolution>& registeredPuzzleSolutions();
+	const RegisteredPuzzleSolution* findRegisteredPuzzleSolution(std::string_view puzzleId);
+	const RegisteredPuzzleSolution* findRegisteredPuzzleSolution(const std::type_info& typeInfo);
+
+	class PuzzleRun
+	{
+	public:
+		const RegisteredPuzzleSolution* puzzleSolution_ = nullptr;
+		std::string puzzleInputFilePath_;
+	};
+
+	class PuzzleRunResult
+	{
+	public:
+		std::string_view puzzleId_;
+		std::array<int, 2> answers_ = {};
+		PhaseTimings::Duration duration_ = {};
+		// Set if solving panicked, in which case the answers are zero.
+		std::string error_;
+	};
+
+	// Solves every puzzle with a fresh solution instance on a pool of
+	// numThreads workers, each taking the next pending puzzle when it is
+	// done with the previous one; results are in the order of puzzleRuns. A
+	// puzzle on which the solution panics gets an error result, without
+	// stopping the others.
+	std::vector<PuzzleRunResult> solvePuzzles(const std::vector<PuzzleRun>& puzzleRuns,
+	                                          unsigned numThreads);
+
+	// Replaces directories with the regular files they contain, ordered by
+	// name, and @list-file with the paths listed in it, one per line.
+	std::vector<std::string> expandBatchInputPaths(const std::vector<std::string>& batchInputPaths);
+
+	// Solves one puzzle for many inputs on a pool of numThreads workers. Each
+	// worker creates a single solution instance and reuses it, along with
+	// its input buffer, for every input it takes; results are in the order
+	// of puzzleInputFilePaths. An input on which the solution panics gets
+	// an error result and a fresh instance takes over for the remaining
+	// ones.
+	std::vector<PuzzleRunResult> solvePuzzleBatch(const RegisteredPuzzleSolution& puzzleSolution,
+	                                              const std::vector<std::string>& puzzleInputFilePaths,
+	                                              unsigned numThreads);
+
+	// Serves requests for the registered solutions on a Unix domain socket
+	// until a shutdown request arrives. Each of numThreads workers accepts
+	// connections and keeps the solution instances it has created, so that
+	// their buffers and tables stay warm between requests. A connection may
+	// send any number of requests, each answered with a single line:
+	//
+	//   solve yyyydd puzzle-input-file\n          -> ok answer1 answer2\n
+	//   solve-inline yyyydd size\n<size bytes>    -> ok answer1 answer2\n
+	//   shutdown\n                                -> ok\n
+	//
+	// Failures, including panics while solving, are answered with
+	// "error message\n" and leave the connection open, except for inline
+	// payloads larger than maxInlinePayloadSize, after which the connection
+	// is closed as the payload is not read. Request lines longer than
+	// maxRequestLineSize close the connection, too. Shutdown stops accepting
+	// connections and waits for the open ones to be closed.
+	constexpr std::size_t maxInlinePayloadSize = std::size_t(1) << 30;
+	constexpr std::size_t maxRequestLineSize = 64 * 1024;
+
+	void servePuzzleSolutions(const std::string& socketPath,
+	                          unsigned numThreads);
 }
 
+#define AOC_REGISTER_PUZZLE_SOLUTION(PuzzleSolutionClass, puzzleId) \
+	static const aoc::PuzzleSolutionRegistration registrationOf##PuzzleSolutionClass{ \
+		puzzleId, \
+		typeid(PuzzleSolutionClass), \
+		[]() -> std::unique_ptr<aoc::PuzzleSolution> { return std::make_unique<PuzzleSolutionClass>(); }}
+
 #endif